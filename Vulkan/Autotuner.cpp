@@ -0,0 +1,144 @@
+#include "Autotuner.h"
+
+namespace Vulkan
+{
+  std::vector<WorkgroupSize> Autotuner::GetDefaultCandidates(const std::shared_ptr<Device> dev, const AutotuneConfig &config)
+  {
+    auto limits = dev->GetPhysicalDeviceProperties().limits;
+    auto &ids = config.pipeline_config.autotune_ids;
+    std::vector<WorkgroupSize> result;
+
+    for (uint32_t x = 16; x <= limits.maxComputeWorkGroupSize[0]; x *= 2)
+    {
+      if (!ids[1].has_value())
+      {
+        if (x <= limits.maxComputeWorkGroupInvocations)
+          result.push_back({ x, 1, 1 });
+        continue;
+      }
+
+      for (uint32_t y = 1; y <= limits.maxComputeWorkGroupSize[1] && x * y <= limits.maxComputeWorkGroupInvocations; y *= 2)
+      {
+        if (x * y >= 32)
+          result.push_back({ x, y, 1 });
+      }
+    }
+
+    return result;
+  }
+
+  std::optional<double> Autotuner::Measure(const std::shared_ptr<Device> dev, CommandPool &pool, const TimestampQueryPool &queries, const AutotuneConfig &config, const WorkgroupSize size)
+  {
+    ComputePipelineConfig pipeline_config = config.pipeline_config;
+    auto &ids = pipeline_config.autotune_ids;
+    const uint32_t sizes[3] = { size.x, size.y, size.z };
+    for (size_t d = 0; d < 3; ++d)
+    {
+      if (ids[d].has_value())
+        pipeline_config.specialization.Set(ids[d].value(), sizes[d]);
+    }
+    pipeline_config.autotune_name.clear();
+
+    ComputePipeline pipeline(dev, pipeline_config);
+    if (!pipeline.IsValid())
+      return {};
+
+    auto &cmd = pool.GetCommandBuffer(0);
+    Fence fence(dev);
+    std::optional<double> best;
+
+    for (uint32_t r = 0; r <= config.repeats; ++r)
+    {
+      bool timed = r > 0 && queries.IsValid();
+      cmd.BeginCommandBuffer(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+      if (timed)
+        cmd.ResetQueryPool(queries.GetQueryPool(), 0, 2);
+      cmd.BindPipeline(pipeline);
+      if (!config.desc_sets.empty())
+        cmd.BindDescriptorSets(pipeline.GetLayout(), VK_PIPELINE_BIND_POINT_COMPUTE, config.desc_sets, 0, {});
+      if (timed)
+        cmd.WriteTimestamp(queries.GetQueryPool(), 0, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+      for (uint32_t i = 0; i < config.iterations; ++i)
+        cmd.DispatchThreads(config.threads.x, config.threads.y, config.threads.z);
+      if (timed)
+        cmd.WriteTimestamp(queries.GetQueryPool(), 1, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+      cmd.EndCommandBuffer();
+
+      fence.Reset();
+      auto start = std::chrono::steady_clock::now();
+      if (pool.ExecuteBuffer(0, fence.GetFence()) != VK_SUCCESS || fence.Wait() != VK_SUCCESS)
+        return {};
+      auto end = std::chrono::steady_clock::now();
+
+      if (r == 0)
+        continue;
+
+      auto time = timed ? queries.GetElapsed(0, 1) : std::chrono::duration<double, std::nano>(end - start).count();
+      if (!time.has_value())
+        return {};
+      if (!best.has_value() || time.value() < best.value())
+        best = time;
+    }
+
+    return best;
+  }
+
+  VkResult Autotuner::Tune(const std::shared_ptr<Device> dev, const AutotuneConfig &config)
+  {
+    if (dev.get() == nullptr || !dev->IsValid())
+    {
+      Logger::EchoError("Device is empty", __func__);
+      return VK_ERROR_UNKNOWN;
+    }
+
+    auto &name = config.pipeline_config.autotune_name;
+    if (name.empty() || !config.pipeline_config.autotune_ids[0].has_value())
+    {
+      Logger::EchoError("Pipeline config has no autotune parameters", __func__);
+      return VK_ERROR_UNKNOWN;
+    }
+
+    if (!config.retune && dev->GetTunedWorkgroupSize(name).has_value())
+      return VK_SUCCESS;
+
+    auto family = dev->GetComputeFamilyQueueIndex();
+    if (!family.has_value())
+    {
+      Logger::EchoError("No compute queue", __func__);
+      return VK_ERROR_UNKNOWN;
+    }
+
+    CommandPool pool(dev, family.value());
+    if (!pool.IsValid())
+      return VK_ERROR_UNKNOWN;
+
+    TimestampQueryPool queries(dev, 2, family.value());
+    if (!queries.IsValid())
+      Logger::EchoWarning("Timestamps are not supported, using host timing", __func__);
+
+    auto candidates = config.candidates.empty() ? GetDefaultCandidates(dev, config) : config.candidates;
+    std::optional<WorkgroupSize> best;
+    double best_time = std::numeric_limits<double>::max();
+
+    for (auto &c : candidates)
+    {
+      auto time = Measure(dev, pool, queries, config, c);
+      if (time.has_value() && time.value() < best_time)
+      {
+        best_time = time.value();
+        best = c;
+      }
+    }
+
+    if (!best.has_value())
+    {
+      Logger::EchoError("No valid candidates for " + name, __func__);
+      return VK_ERROR_UNKNOWN;
+    }
+
+    Logger::EchoDebug(name + ": " + std::to_string(best->x) + "x" + std::to_string(best->y) + "x" + std::to_string(best->z), __func__);
+    dev->SetTunedWorkgroupSize(name, best.value());
+
+    return dev->SaveAutotuneResults();
+  }
+}
\ No newline at end of file
@@ -0,0 +1,53 @@
+#ifndef __VULKAN_AUTOTUNER_H
+#define __VULKAN_AUTOTUNER_H
+
+#include "Logger.h"
+#include "Device.h"
+#include "CommandPool.h"
+#include "Fence.h"
+#include "QueryPool.h"
+#include "Pipelines/ComputePipeline.h"
+
+#include <vulkan/vulkan.h>
+#include <memory>
+#include <vector>
+#include <chrono>
+#include <limits>
+
+namespace Vulkan
+{
+  class AutotuneConfig
+  {
+  private:
+    friend class Autotuner;
+    ComputePipelineConfig pipeline_config;
+    std::vector<WorkgroupSize> candidates;
+    std::vector<VkDescriptorSet> desc_sets;
+    WorkgroupSize threads;
+    uint32_t iterations = 5;
+    uint32_t repeats = 3;
+    bool retune = false;
+  public:
+    AutotuneConfig() = default;
+    ~AutotuneConfig() noexcept = default;
+    auto &SetPipelineConfig(const ComputePipelineConfig &config) { pipeline_config = config; return *this; }
+    auto &AddCandidate(const WorkgroupSize size) { candidates.push_back(size); return *this; }
+    auto &SetDescriptorSets(const std::vector<VkDescriptorSet> sets) { desc_sets = sets; return *this; }
+    auto &SetThreads(const uint32_t x, const uint32_t y = 1, const uint32_t z = 1) noexcept { threads = { x, y, z }; return *this; }
+    auto &SetIterations(const uint32_t count) noexcept { iterations = std::max(count, (uint32_t) 1); return *this; }
+    auto &SetRepeats(const uint32_t count) noexcept { repeats = std::max(count, (uint32_t) 1); return *this; }
+    auto &Retune(const bool val) noexcept { retune = val; return *this; }
+  };
+
+  class Autotuner
+  {
+  private:
+    static std::vector<WorkgroupSize> GetDefaultCandidates(const std::shared_ptr<Device> dev, const AutotuneConfig &config);
+    static std::optional<double> Measure(const std::shared_ptr<Device> dev, CommandPool &pool, const TimestampQueryPool &queries, const AutotuneConfig &config, const WorkgroupSize size);
+  public:
+    Autotuner() = delete;
+    static VkResult Tune(const std::shared_ptr<Device> dev, const AutotuneConfig &config);
+  };
+}
+
+#endif
\ No newline at end of file
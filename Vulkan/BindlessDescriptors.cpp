@@ -0,0 +1,291 @@
+#include "BindlessDescriptors.h"
+
+namespace Vulkan
+{
+  BindlessDescriptors_impl::~BindlessDescriptors_impl() noexcept
+  {
+    Logger::EchoDebug("", __func__);
+    if (device == nullptr || device->GetDevice() == VK_NULL_HANDLE)
+      return;
+
+    if (descriptor_pool != VK_NULL_HANDLE)
+      vkDestroyDescriptorPool(device->GetDevice(), descriptor_pool, nullptr);
+    if (layout != VK_NULL_HANDLE)
+      vkDestroyDescriptorSetLayout(device->GetDevice(), layout, nullptr);
+  }
+
+  bool BindlessDescriptors_impl::IsSupported(const std::shared_ptr<Device> &dev) noexcept
+  {
+    if (dev.get() == nullptr || !dev->IsValid())
+      return false;
+
+    auto f = dev->GetEnabledVulkan12Features();
+    return f.runtimeDescriptorArray && f.descriptorBindingPartiallyBound && f.descriptorBindingUpdateUnusedWhilePending &&
+           f.descriptorBindingStorageBufferUpdateAfterBind && f.descriptorBindingSampledImageUpdateAfterBind &&
+           f.descriptorBindingStorageImageUpdateAfterBind && f.shaderStorageBufferArrayNonUniformIndexing &&
+           f.shaderSampledImageArrayNonUniformIndexing && f.shaderStorageImageArrayNonUniformIndexing;
+  }
+
+  VkDescriptorType BindlessDescriptors_impl::GetDescriptorType(const BindlessType type) noexcept
+  {
+    switch (type)
+    {
+      case BindlessType::StorageBuffer:
+        return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+      case BindlessType::SampledImage:
+        return VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+      case BindlessType::StorageImage:
+        return VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+      case BindlessType::Sampler:
+        return VK_DESCRIPTOR_TYPE_SAMPLER;
+    }
+
+    return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  }
+
+  BindlessDescriptors_impl::BindlessDescriptors_impl(std::shared_ptr<Device> dev, const BindlessConfig &params)
+  {
+    if (!IsSupported(dev))
+    {
+      Logger::EchoError("Descriptor indexing is not supported", __func__);
+      return;
+    }
+
+    VkPhysicalDeviceVulkan12Properties props12 = {};
+    props12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES;
+    VkPhysicalDeviceProperties2 props = {};
+    props.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    props.pNext = &props12;
+    vkGetPhysicalDeviceProperties2(dev->GetPhysicalDevice(), &props);
+
+    std::array<uint32_t, 4> limits = {
+      std::min(props12.maxDescriptorSetUpdateAfterBindStorageBuffers, props12.maxPerStageDescriptorUpdateAfterBindStorageBuffers),
+      std::min(props12.maxDescriptorSetUpdateAfterBindSampledImages, props12.maxPerStageDescriptorUpdateAfterBindSampledImages),
+      std::min(props12.maxDescriptorSetUpdateAfterBindStorageImages, props12.maxPerStageDescriptorUpdateAfterBindStorageImages),
+      std::min(props12.maxDescriptorSetUpdateAfterBindSamplers, props12.maxPerStageDescriptorUpdateAfterBindSamplers)
+    };
+
+    std::vector<VkDescriptorSetLayoutBinding> bindings;
+    std::vector<VkDescriptorBindingFlags> binding_flags;
+    std::vector<VkDescriptorPoolSize> sizes;
+    for (size_t i = 0; i < slots.size(); ++i)
+    {
+      slots[i].capacity = std::min(params.counts[i], limits[i]);
+      if (slots[i].capacity < params.counts[i])
+        Logger::EchoWarning("Bindless binding " + std::to_string(i) + " is clamped to " + std::to_string(slots[i].capacity), __func__);
+      if (slots[i].capacity == 0)
+        continue;
+
+      VkDescriptorSetLayoutBinding binding = {};
+      binding.binding = (uint32_t) i;
+      binding.descriptorType = GetDescriptorType((BindlessType) i);
+      binding.descriptorCount = slots[i].capacity;
+      binding.stageFlags = params.stages;
+      bindings.push_back(binding);
+      binding_flags.push_back(VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT | VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT);
+      sizes.push_back({binding.descriptorType, binding.descriptorCount});
+    }
+
+    if (bindings.empty())
+    {
+      Logger::EchoError("No bindless bindings", __func__);
+      return;
+    }
+
+    VkDescriptorSetLayoutBindingFlagsCreateInfo binding_flags_info = {};
+    binding_flags_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+    binding_flags_info.bindingCount = (uint32_t) binding_flags.size();
+    binding_flags_info.pBindingFlags = binding_flags.data();
+
+    VkDescriptorSetLayoutCreateInfo layout_create_info = {};
+    layout_create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layout_create_info.pNext = &binding_flags_info;
+    layout_create_info.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+    layout_create_info.bindingCount = (uint32_t) bindings.size();
+    layout_create_info.pBindings = bindings.data();
+
+    if (auto er = vkCreateDescriptorSetLayout(dev->GetDevice(), &layout_create_info, nullptr, &layout); er != VK_SUCCESS)
+    {
+      Logger::EchoError("Can't create bindless DescriptorSetLayout", __func__);
+      Logger::EchoDebug("Return code = " + std::to_string(er), __func__);
+      return;
+    }
+
+    device = dev;
+    frames_in_flight = params.frames_in_flight;
+
+    VkDescriptorPoolCreateInfo pool_create_info = {};
+    pool_create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    pool_create_info.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+    pool_create_info.maxSets = 1;
+    pool_create_info.poolSizeCount = (uint32_t) sizes.size();
+    pool_create_info.pPoolSizes = sizes.data();
+
+    if (auto er = vkCreateDescriptorPool(device->GetDevice(), &pool_create_info, nullptr, &descriptor_pool); er != VK_SUCCESS)
+    {
+      Logger::EchoError("Can't create bindless descriptor pool", __func__);
+      Logger::EchoDebug("Return code = " + std::to_string(er), __func__);
+      return;
+    }
+
+    VkDescriptorSetAllocateInfo alloc_info = {};
+    alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    alloc_info.descriptorPool = descriptor_pool;
+    alloc_info.descriptorSetCount = 1;
+    alloc_info.pSetLayouts = &layout;
+
+    if (auto er = vkAllocateDescriptorSets(device->GetDevice(), &alloc_info, &set); er != VK_SUCCESS)
+    {
+      Logger::EchoError("Failed to allocate bindless descriptor set", __func__);
+      Logger::EchoDebug("Return code = " + std::to_string(er), __func__);
+      set = VK_NULL_HANDLE;
+    }
+  }
+
+  std::optional<uint32_t> BindlessDescriptors_impl::AcquireSlot(const BindlessType type)
+  {
+    std::lock_guard lock(slots_mutex);
+    auto &s = slots[(size_t) type];
+    if (!s.free.empty())
+    {
+      auto index = s.free.back();
+      s.free.pop_back();
+      return index;
+    }
+
+    if (s.next >= s.capacity)
+    {
+      Logger::EchoError("No free bindless slots for binding " + std::to_string((size_t) type), __func__);
+      return {};
+    }
+
+    return s.next++;
+  }
+
+  std::optional<uint32_t> BindlessDescriptors_impl::Write(const BindlessType type, const VkDescriptorBufferInfo *buffer_info, const VkDescriptorImageInfo *image_info)
+  {
+    auto index = AcquireSlot(type);
+    if (!index.has_value())
+      return index;
+
+    VkWriteDescriptorSet write = {};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = set;
+    write.dstBinding = (uint32_t) type;
+    write.dstArrayElement = index.value();
+    write.descriptorCount = 1;
+    write.descriptorType = GetDescriptorType(type);
+    write.pBufferInfo = buffer_info;
+    write.pImageInfo = image_info;
+    vkUpdateDescriptorSets(device->GetDevice(), 1, &write, 0, nullptr);
+
+    return index;
+  }
+
+  std::optional<uint32_t> BindlessDescriptors_impl::AddBuffer(const VkBuffer buffer, const VkDeviceSize offset, const VkDeviceSize size)
+  {
+    if (buffer == VK_NULL_HANDLE || size == 0)
+    {
+      Logger::EchoError("Buffer is empty", __func__);
+      return {};
+    }
+
+    VkDescriptorBufferInfo info = { buffer, offset, size };
+    return Write(BindlessType::StorageBuffer, &info, nullptr);
+  }
+
+  std::optional<uint32_t> BindlessDescriptors_impl::AddImage(const VkImageView image_view, const VkImageLayout image_layout, const BindlessType type)
+  {
+    if (image_view == VK_NULL_HANDLE || (type != BindlessType::SampledImage && type != BindlessType::StorageImage))
+    {
+      Logger::EchoError("Image is empty or type is not an image", __func__);
+      return {};
+    }
+
+    VkDescriptorImageInfo info = { VK_NULL_HANDLE, image_view, image_layout };
+    return Write(type, nullptr, &info);
+  }
+
+  std::optional<uint32_t> BindlessDescriptors_impl::AddSampler(const VkSampler sampler)
+  {
+    if (sampler == VK_NULL_HANDLE)
+    {
+      Logger::EchoError("Sampler is empty", __func__);
+      return {};
+    }
+
+    VkDescriptorImageInfo info = { sampler, VK_NULL_HANDLE, VK_IMAGE_LAYOUT_UNDEFINED };
+    return Write(BindlessType::Sampler, nullptr, &info);
+  }
+
+  void BindlessDescriptors_impl::Remove(const BindlessType type, const uint32_t index)
+  {
+    std::lock_guard lock(slots_mutex);
+    auto &s = slots[(size_t) type];
+    auto retired = std::find_if(s.retired.begin(), s.retired.end(), [index] (const auto &r) { return r.first == index; });
+    if (index >= s.next || std::find(s.free.begin(), s.free.end(), index) != s.free.end() || retired != s.retired.end())
+    {
+      Logger::EchoWarning("Slot is not in use", __func__);
+      return;
+    }
+
+    s.retired.push_back({index, frame});
+  }
+
+  void BindlessDescriptors_impl::BeginFrame()
+  {
+    std::lock_guard lock(slots_mutex);
+    ++frame;
+    for (auto &s : slots)
+    {
+      while (!s.retired.empty() && s.retired.front().second + frames_in_flight <= frame)
+      {
+        s.free.push_back(s.retired.front().first);
+        s.retired.pop_front();
+      }
+    }
+  }
+
+  std::optional<uint32_t> BindlessDescriptors::AddSubBuffer(const StorageArray &array, const size_t buffer_index, const size_t sub_buffer_index)
+  {
+    auto info = array.GetInfo(buffer_index);
+    if (sub_buffer_index >= info.sub_buffers.size())
+    {
+      Logger::EchoError("Index is out off range", __func__);
+      return {};
+    }
+
+    return AddBuffer(info.buffer, info.sub_buffers[sub_buffer_index].offset, info.sub_buffers[sub_buffer_index].size);
+  }
+
+  std::optional<uint32_t> BindlessDescriptors::AddImage(ImageArray &array, const size_t index)
+  {
+    auto info = array.GetInfo(index);
+    if (info.type == ImageType::Storage)
+      return AddImage(info.image_view, VK_IMAGE_LAYOUT_GENERAL, BindlessType::StorageImage);
+
+    return AddImage(info.image_view, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, BindlessType::SampledImage);
+  }
+
+  BindlessDescriptors &BindlessDescriptors::operator=(BindlessDescriptors &&obj) noexcept
+  {
+    if (&obj == this) return *this;
+
+    impl = std::move(obj.impl);
+    return *this;
+  }
+
+  void BindlessDescriptors::swap(BindlessDescriptors &obj) noexcept
+  {
+    if (&obj == this) return;
+
+    impl.swap(obj.impl);
+  }
+
+  void swap(BindlessDescriptors &lhs, BindlessDescriptors &rhs) noexcept
+  {
+    if (&lhs == &rhs) return;
+
+    lhs.swap(rhs);
+  }
+}
\ No newline at end of file
@@ -0,0 +1,121 @@
+#ifndef __VULKAN_BINDLESS_DESCRIPTORS_H
+#define __VULKAN_BINDLESS_DESCRIPTORS_H
+
+#include "Logger.h"
+#include "Device.h"
+#include "StorageArray.h"
+#include "ImageArray.h"
+
+#include <vulkan/vulkan.h>
+#include <memory>
+#include <vector>
+#include <array>
+#include <optional>
+#include <mutex>
+#include <deque>
+
+namespace Vulkan
+{
+  enum class BindlessType
+  {
+    StorageBuffer = 0,
+    SampledImage = 1,
+    StorageImage = 2,
+    Sampler = 3
+  };
+
+  class BindlessConfig
+  {
+  private:
+    friend class BindlessDescriptors_impl;
+    std::array<uint32_t, 4> counts = { 65536, 16384, 4096, 256 };
+    VkShaderStageFlags stages = VK_SHADER_STAGE_ALL;
+    uint64_t frames_in_flight = 2;
+  public:
+    BindlessConfig() = default;
+    ~BindlessConfig() noexcept = default;
+    auto &SetDescriptorsCount(const BindlessType type, const uint32_t count) { counts[(size_t) type] = count; return *this; }
+    auto &SetStages(const VkShaderStageFlags flags) { stages = flags; return *this; }
+    auto &SetFramesInFlight(const uint64_t count) { frames_in_flight = count; return *this; }
+  };
+
+  class BindlessDescriptors_impl
+  {
+  public:
+    BindlessDescriptors_impl() = delete;
+    BindlessDescriptors_impl(const BindlessDescriptors_impl &obj) = delete;
+    BindlessDescriptors_impl(BindlessDescriptors_impl &&obj) = delete;
+    BindlessDescriptors_impl &operator=(const BindlessDescriptors_impl &obj) = delete;
+    BindlessDescriptors_impl &operator=(BindlessDescriptors_impl &&obj) = delete;
+    ~BindlessDescriptors_impl() noexcept;
+  private:
+    friend class BindlessDescriptors;
+    struct Slots
+    {
+      uint32_t capacity = 0;
+      uint32_t next = 0;
+      std::vector<uint32_t> free;
+      std::deque<std::pair<uint32_t, uint64_t>> retired;
+    };
+
+    std::shared_ptr<Device> device;
+    VkDescriptorSetLayout layout = VK_NULL_HANDLE;
+    VkDescriptorPool descriptor_pool = VK_NULL_HANDLE;
+    VkDescriptorSet set = VK_NULL_HANDLE;
+    std::array<Slots, 4> slots;
+    uint64_t frames_in_flight = 2;
+    uint64_t frame = 0;
+    std::mutex slots_mutex;
+
+    BindlessDescriptors_impl(std::shared_ptr<Device> dev, const BindlessConfig &params);
+    static VkDescriptorType GetDescriptorType(const BindlessType type) noexcept;
+    static bool IsSupported(const std::shared_ptr<Device> &dev) noexcept;
+    std::optional<uint32_t> AcquireSlot(const BindlessType type);
+    std::optional<uint32_t> Write(const BindlessType type, const VkDescriptorBufferInfo *buffer_info, const VkDescriptorImageInfo *image_info);
+    std::optional<uint32_t> AddBuffer(const VkBuffer buffer, const VkDeviceSize offset, const VkDeviceSize size);
+    std::optional<uint32_t> AddImage(const VkImageView image_view, const VkImageLayout image_layout, const BindlessType type);
+    std::optional<uint32_t> AddSampler(const VkSampler sampler);
+    void Remove(const BindlessType type, const uint32_t index);
+    void BeginFrame();
+    uint32_t GetCapacity(const BindlessType type) const noexcept { return slots[(size_t) type].capacity; }
+    VkDescriptorSetLayout GetDescriptorSetLayout() const noexcept { return layout; }
+    VkDescriptorSet GetDescriptorSet() const noexcept { return set; }
+    std::shared_ptr<Device> GetDevice() const noexcept { return device; }
+  };
+
+  class BindlessDescriptors
+  {
+  private:
+    std::unique_ptr<BindlessDescriptors_impl> impl;
+  public:
+    BindlessDescriptors() = delete;
+    BindlessDescriptors(const BindlessDescriptors &obj) = delete;
+    BindlessDescriptors(BindlessDescriptors &&obj) noexcept : impl(std::move(obj.impl)) {};
+    BindlessDescriptors(std::shared_ptr<Device> dev, const BindlessConfig &params = {}) :
+      impl(std::unique_ptr<BindlessDescriptors_impl>(new BindlessDescriptors_impl(dev, params))) {};
+    BindlessDescriptors &operator=(const BindlessDescriptors &obj) = delete;
+    BindlessDescriptors &operator=(BindlessDescriptors &&obj) noexcept;
+    ~BindlessDescriptors() noexcept = default;
+    void swap(BindlessDescriptors &obj) noexcept;
+    bool IsValid() const noexcept { return impl.get() && impl->set != VK_NULL_HANDLE; }
+    // Shaders may index the bindless arrays with nonuniformEXT, so non-uniform indexing is required for every array type
+    static bool IsSupported(const std::shared_ptr<Device> &dev) noexcept { return BindlessDescriptors_impl::IsSupported(dev); }
+
+    std::optional<uint32_t> AddBuffer(const VkBuffer buffer, const VkDeviceSize offset, const VkDeviceSize size) { if (IsValid()) return impl->AddBuffer(buffer, offset, size); return {}; }
+    std::optional<uint32_t> AddSubBuffer(const StorageArray &array, const size_t buffer_index, const size_t sub_buffer_index);
+    std::optional<uint32_t> AddImage(const VkImageView image_view, const VkImageLayout image_layout, const BindlessType type = BindlessType::SampledImage) { if (IsValid()) return impl->AddImage(image_view, image_layout, type); return {}; }
+    std::optional<uint32_t> AddImage(ImageArray &array, const size_t index);
+    std::optional<uint32_t> AddSampler(const VkSampler sampler) { if (IsValid()) return impl->AddSampler(sampler); return {}; }
+    void Remove(const BindlessType type, const uint32_t index) { if (IsValid()) impl->Remove(type, index); }
+    // Must be called after the fence of the oldest in-flight frame has been waited on
+    void BeginFrame() { if (IsValid()) impl->BeginFrame(); }
+    uint32_t GetCapacity(const BindlessType type) const noexcept { if (impl.get()) return impl->GetCapacity(type); return 0; }
+    VkDescriptorSetLayout GetDescriptorSetLayout() const noexcept { if (impl.get()) return impl->GetDescriptorSetLayout(); return VK_NULL_HANDLE; }
+    VkDescriptorSet GetDescriptorSet() const noexcept { if (impl.get()) return impl->GetDescriptorSet(); return VK_NULL_HANDLE; }
+    std::shared_ptr<Device> GetDevice() const noexcept { if (impl.get()) return impl->GetDevice(); return nullptr; }
+  };
+
+  void swap(BindlessDescriptors &lhs, BindlessDescriptors &rhs) noexcept;
+}
+
+#endif
\ No newline at end of file
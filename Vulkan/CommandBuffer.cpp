@@ -55,11 +55,11 @@ namespace Vulkan
                         (uint32_t) image_bariers.size(), image_bariers.size() > 0 ? image_bariers.data() : nullptr);
   }
 
-  void CommandBuffer_impl::BeginCommandBuffer()
+  void CommandBuffer_impl::BeginCommandBuffer(const VkCommandBufferUsageFlags usage_flags)
   {
     VkCommandBufferBeginInfo begin_info = {};
     begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-    begin_info.flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
+    begin_info.flags = usage_flags;
     begin_info.pInheritanceInfo = nullptr;
 
     if (auto er = vkBeginCommandBuffer(buffer, &begin_info); er != VK_SUCCESS) 
@@ -103,7 +103,7 @@ namespace Vulkan
     }
   }
 
-  VkResult CommandBuffer_impl::ExecuteBuffer(const uint32_t family_queue_index, VkFence exec_fence, std::vector<VkSemaphore> signal_semaphores, const std::vector<VkPipelineStageFlags> wait_dst_stages, const std::vector<VkSemaphore> wait_semaphores)
+  VkResult CommandBuffer_impl::ExecuteBuffer(const uint32_t family_queue_index, const uint32_t queue_index, VkFence exec_fence, std::vector<VkSemaphore> signal_semaphores, const std::vector<VkPipelineStageFlags> wait_dst_stages, const std::vector<VkSemaphore> wait_semaphores, const std::vector<uint64_t> signal_values, const std::vector<uint64_t> wait_values)
   {
     if (wait_dst_stages.size() != wait_semaphores.size())
     {
@@ -112,6 +112,14 @@ namespace Vulkan
       return VK_ERROR_UNKNOWN;
     }
 
+    if ((!signal_values.empty() && signal_values.size() != signal_semaphores.size()) ||
+        (!wait_values.empty() && wait_values.size() != wait_semaphores.size()))
+    {
+      Logger::EchoError("Timeline values count != semaphores count", __func__);
+      state = BufferState::Error;
+      return VK_ERROR_UNKNOWN;
+    }
+
     VkSubmitInfo submit_info = {};
     submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
     submit_info.commandBufferCount = 1;
@@ -123,7 +131,27 @@ namespace Vulkan
     submit_info.signalSemaphoreCount = (uint32_t) signal_semaphores.size();
     submit_info.pSignalSemaphores = signal_semaphores.size() > 0 ? signal_semaphores.data() : nullptr; 
 
-    if (auto er = vkQueueSubmit(device->GetQueueFormFamilyIndex(family_queue_index), 1, &submit_info, exec_fence); er != VK_SUCCESS)
+    // Values of binary semaphores are ignored, so zeros are fine for them.
+    VkTimelineSemaphoreSubmitInfo timeline_info = {};
+    if (!signal_values.empty() || !wait_values.empty())
+    {
+      timeline_info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+      timeline_info.signalSemaphoreValueCount = (uint32_t) signal_values.size();
+      timeline_info.pSignalSemaphoreValues = signal_values.size() > 0 ? signal_values.data() : nullptr;
+      timeline_info.waitSemaphoreValueCount = (uint32_t) wait_values.size();
+      timeline_info.pWaitSemaphoreValues = wait_values.size() > 0 ? wait_values.data() : nullptr;
+      submit_info.pNext = &timeline_info;
+    }
+
+    VkQueue queue = device->GetQueue(family_queue_index, queue_index);
+    if (queue == VK_NULL_HANDLE)
+    {
+      Logger::EchoError("Queue is not available", __func__);
+      state = BufferState::Error;
+      return VK_ERROR_UNKNOWN;
+    }
+
+    if (auto er = vkQueueSubmit(queue, 1, &submit_info, exec_fence); er != VK_SUCCESS)
     {
       Logger::EchoError("Failed to submit buffer", __func__);
       Logger::EchoDebug("Return code = " + std::to_string(er), __func__);
@@ -190,6 +218,128 @@ namespace Vulkan
     vkCmdDispatch(buffer, x, y, z);
   }
 
+  void CommandBuffer_impl::DrawIndirect(const VkBuffer buffer, const VkDeviceSize offset, const uint32_t draw_count, const uint32_t stride) noexcept
+  {
+    if (draw_count > 1 && !device->GetEnabledFeatures().multiDrawIndirect)
+    {
+      Logger::EchoError("multiDrawIndirect feature is not enabled", __func__);
+      return;
+    }
+
+    vkCmdDrawIndirect(this->buffer, buffer, offset, draw_count, stride);
+  }
+
+  void CommandBuffer_impl::DrawIndexedIndirect(const VkBuffer buffer, const VkDeviceSize offset, const uint32_t draw_count, const uint32_t stride) noexcept
+  {
+    if (draw_count > 1 && !device->GetEnabledFeatures().multiDrawIndirect)
+    {
+      Logger::EchoError("multiDrawIndirect feature is not enabled", __func__);
+      return;
+    }
+
+    vkCmdDrawIndexedIndirect(this->buffer, buffer, offset, draw_count, stride);
+  }
+
+  void CommandBuffer_impl::DrawIndirectCount(const VkBuffer buffer, const VkDeviceSize offset, const VkBuffer count_buffer, const VkDeviceSize count_offset, const uint32_t max_draw_count, const uint32_t stride)
+  {
+    if (!device->GetEnabledVulkan12Features().drawIndirectCount)
+    {
+      Logger::EchoError("drawIndirectCount feature is not enabled", __func__);
+      return;
+    }
+
+    vkCmdDrawIndirectCount(this->buffer, buffer, offset, count_buffer, count_offset, max_draw_count, stride);
+  }
+
+  void CommandBuffer_impl::DrawIndexedIndirectCount(const VkBuffer buffer, const VkDeviceSize offset, const VkBuffer count_buffer, const VkDeviceSize count_offset, const uint32_t max_draw_count, const uint32_t stride)
+  {
+    if (!device->GetEnabledVulkan12Features().drawIndirectCount)
+    {
+      Logger::EchoError("drawIndirectCount feature is not enabled", __func__);
+      return;
+    }
+
+    vkCmdDrawIndexedIndirectCount(this->buffer, buffer, offset, count_buffer, count_offset, max_draw_count, stride);
+  }
+
+  void CommandBuffer_impl::DispatchThreads(const uint32_t x, const uint32_t y, const uint32_t z) noexcept
+  {
+    const uint64_t groups[3] = { ((uint64_t) x + workgroup_size.x - 1) / workgroup_size.x,
+                                 ((uint64_t) y + workgroup_size.y - 1) / workgroup_size.y,
+                                 ((uint64_t) z + workgroup_size.z - 1) / workgroup_size.z };
+    if (groups[0] == 0 || groups[1] == 0 || groups[2] == 0)
+      return;
+
+    const uint32_t *max_groups = device->GetPhysicalDeviceProperties().limits.maxComputeWorkGroupCount;
+    if (groups[0] <= max_groups[0] && groups[1] <= max_groups[1] && groups[2] <= max_groups[2])
+    {
+      vkCmdDispatch(buffer, (uint32_t) groups[0], (uint32_t) groups[1], (uint32_t) groups[2]);
+      return;
+    }
+
+    for (uint64_t bz = 0; bz < groups[2]; bz += max_groups[2])
+    {
+      for (uint64_t by = 0; by < groups[1]; by += max_groups[1])
+      {
+        for (uint64_t bx = 0; bx < groups[0]; bx += max_groups[0])
+        {
+          vkCmdDispatchBase(buffer, (uint32_t) bx, (uint32_t) by, (uint32_t) bz,
+                            (uint32_t) std::min<uint64_t>(max_groups[0], groups[0] - bx),
+                            (uint32_t) std::min<uint64_t>(max_groups[1], groups[1] - by),
+                            (uint32_t) std::min<uint64_t>(max_groups[2], groups[2] - bz));
+        }
+      }
+    }
+  }
+
+  void CommandBuffer_impl::DispatchIndirect(const VkBuffer buffer, const VkDeviceSize offset) noexcept
+  {
+    vkCmdDispatchIndirect(this->buffer, buffer, offset);
+  }
+
+  bool CommandBuffer_impl::CheckIndirectRange(const BufferRange &range, const VkDeviceSize required) noexcept
+  {
+    if (range.buffer == VK_NULL_HANDLE || range.size < required)
+    {
+      Logger::EchoError("Indirect buffer range is too small", __func__);
+      return false;
+    }
+
+    return true;
+  }
+
+  void CommandBuffer_impl::DrawIndirect(const BufferRange &range, const uint32_t draw_count, const uint32_t stride) noexcept
+  {
+    if (draw_count == 0 || CheckIndirectRange(range, (VkDeviceSize) (draw_count - 1) * stride + sizeof(VkDrawIndirectCommand)))
+      DrawIndirect(range.buffer, range.offset, draw_count, stride);
+  }
+
+  void CommandBuffer_impl::DrawIndexedIndirect(const BufferRange &range, const uint32_t draw_count, const uint32_t stride) noexcept
+  {
+    if (draw_count == 0 || CheckIndirectRange(range, (VkDeviceSize) (draw_count - 1) * stride + sizeof(VkDrawIndexedIndirectCommand)))
+      DrawIndexedIndirect(range.buffer, range.offset, draw_count, stride);
+  }
+
+  void CommandBuffer_impl::DrawIndirectCount(const BufferRange &range, const BufferRange &count_range, const uint32_t max_draw_count, const uint32_t stride)
+  {
+    if (CheckIndirectRange(count_range, sizeof(uint32_t)) &&
+        (max_draw_count == 0 || CheckIndirectRange(range, (VkDeviceSize) (max_draw_count - 1) * stride + sizeof(VkDrawIndirectCommand))))
+      DrawIndirectCount(range.buffer, range.offset, count_range.buffer, count_range.offset, max_draw_count, stride);
+  }
+
+  void CommandBuffer_impl::DrawIndexedIndirectCount(const BufferRange &range, const BufferRange &count_range, const uint32_t max_draw_count, const uint32_t stride)
+  {
+    if (CheckIndirectRange(count_range, sizeof(uint32_t)) &&
+        (max_draw_count == 0 || CheckIndirectRange(range, (VkDeviceSize) (max_draw_count - 1) * stride + sizeof(VkDrawIndexedIndirectCommand))))
+      DrawIndexedIndirectCount(range.buffer, range.offset, count_range.buffer, count_range.offset, max_draw_count, stride);
+  }
+
+  void CommandBuffer_impl::DispatchIndirect(const BufferRange &range) noexcept
+  {
+    if (CheckIndirectRange(range, sizeof(VkDispatchIndirectCommand)))
+      DispatchIndirect(range.buffer, range.offset);
+  }
+
   void CommandBuffer_impl::BindPipeline(const VkPipeline pipeline, const VkPipelineBindPoint bind_point) noexcept
   {
     if (pipeline == VK_NULL_HANDLE)
@@ -201,6 +351,46 @@ namespace Vulkan
     vkCmdBindPipeline(buffer, bind_point, pipeline);
   }
 
+  void CommandBuffer_impl::BindPipeline(const ComputePipeline &pipeline) noexcept
+  {
+    BindPipeline(pipeline.GetPipeline(), VK_PIPELINE_BIND_POINT_COMPUTE);
+    workgroup_size = pipeline.GetWorkgroupSize();
+  }
+
+  void CommandBuffer_impl::BindPipeline(const PipelineHandle &handle) noexcept
+  {
+    BindPipeline(handle.pipeline, handle.bind_point);
+    if (handle.bind_point == VK_PIPELINE_BIND_POINT_COMPUTE)
+      workgroup_size = handle.workgroup_size;
+  }
+
+  void CommandBuffer_impl::ResetQueryPool(const VkQueryPool query_pool, const uint32_t first_query, const uint32_t query_count) noexcept
+  {
+    vkCmdResetQueryPool(buffer, query_pool, first_query, query_count);
+  }
+
+  void CommandBuffer_impl::WriteTimestamp(const VkQueryPool query_pool, const uint32_t query, const VkPipelineStageFlagBits stage) noexcept
+  {
+    vkCmdWriteTimestamp(buffer, stage, query_pool, query);
+  }
+
+  void CommandBuffer_impl::PushConstants(const VkPipelineLayout pipeline_layout, const VkShaderStageFlags stages, const void *data, const uint32_t size, const uint32_t offset) noexcept
+  {
+    if (data == nullptr || size == 0 || size % 4 != 0 || offset % 4 != 0)
+    {
+      Logger::EchoError("Invalid push constants", __func__);
+      return;
+    }
+
+    if (offset + size > device->GetPhysicalDeviceProperties().limits.maxPushConstantsSize)
+    {
+      Logger::EchoError("Push constants exceed device limit", __func__);
+      return;
+    }
+
+    vkCmdPushConstants(buffer, pipeline_layout, stages, offset, size, data);
+  }
+
   void CommandBuffer_impl::BindDescriptorSets(const VkPipelineLayout pipeline_layout, const VkPipelineBindPoint bind_point, const std::vector<VkDescriptorSet> sets, const uint32_t first_set, const std::vector<uint32_t> dynamic_offeset) noexcept
   {
     vkCmdBindDescriptorSets(buffer, bind_point, pipeline_layout, 
@@ -388,6 +578,28 @@ namespace Vulkan
     vkCmdCopyBuffer(buffer, src, dst, (uint32_t) regions.size(), regions.data());
   }
 
+  void CommandBuffer_impl::FillBuffer(const VkBuffer dst, const VkDeviceSize offset, const VkDeviceSize size, const uint32_t data) noexcept
+  {
+    if (dst == VK_NULL_HANDLE)
+    {
+      Logger::EchoError("Invalid buffer", __func__);
+      state = BufferState::Error;
+      return;
+    }
+
+    vkCmdFillBuffer(buffer, dst, offset, size, data);
+  }
+
+  void CommandBuffer_impl::ComputeBarrier() noexcept
+  {
+    VkMemoryBarrier barrier = {};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+
+    SetMemoryBarrier({}, { barrier }, {}, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT);
+  }
+
   CommandBuffer &CommandBuffer::operator=(CommandBuffer &&obj) noexcept
   {
     if (&obj == this) return *this;
@@ -4,6 +4,8 @@
 #include "Logger.h"
 #include "Device.h"
 #include "RenderPass.h"
+#include "StorageArray.h"
+#include "Pipelines/ComputePipeline.h"
 
 #include <vulkan/vulkan.h>
 #include <memory>
@@ -21,10 +23,12 @@ namespace Vulkan
     ~CommandBuffer_impl() noexcept;
   private:
     friend class CommandBuffer;
+    friend class CommandPool_impl;
     std::shared_ptr<Device> device;
     VkCommandBuffer buffer = VK_NULL_HANDLE;
     VkCommandPool pool = VK_NULL_HANDLE;
     VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    WorkgroupSize workgroup_size;
     enum class BufferState
     {
       NotReady,
@@ -46,14 +50,18 @@ namespace Vulkan
     std::shared_ptr<Device> GetDevice() const noexcept { return device; }
     VkCommandBuffer GetBuffer() const noexcept { return buffer; }
 
-    void BeginCommandBuffer();
+    void BeginCommandBuffer(const VkCommandBufferUsageFlags usage_flags);
     void EndCommandBuffer();
     void ResetCommandBuffer();
+    void MarkAsReset() noexcept { state = BufferState::NotReady; }
     VkResult ExecuteBuffer(const uint32_t family_queue_index,
+                           const uint32_t queue_index,
                            VkFence exec_fence,
                            std::vector<VkSemaphore> signal_semaphores, 
                            const std::vector<VkPipelineStageFlags> wait_dst_stages, 
-                           const std::vector<VkSemaphore> wait_semaphores);
+                           const std::vector<VkSemaphore> wait_semaphores,
+                           const std::vector<uint64_t> signal_values,
+                           const std::vector<uint64_t> wait_values);
 
     void BeginRenderPass(const std::shared_ptr<Vulkan::RenderPass> render_pass, const uint32_t frame_buffer_index, const VkOffset2D offset = {0, 0});
     void EndRenderPass() noexcept;
@@ -62,8 +70,26 @@ namespace Vulkan
     void DrawIndexed(const uint32_t index_count, const uint32_t first_index, const uint32_t vertex_offset = 0, const uint32_t instance_count = 1, const uint32_t first_instance = 0) noexcept;
     void Draw(const uint32_t vertex_count, const uint32_t first_vertex = 0, const uint32_t instance_count = 1, const uint32_t first_instance = 0) noexcept;
     void Dispatch(const uint32_t x, const uint32_t y, const uint32_t z) noexcept;
+    void DrawIndirect(const VkBuffer buffer, const VkDeviceSize offset, const uint32_t draw_count = 1, const uint32_t stride = sizeof(VkDrawIndirectCommand)) noexcept;
+    void DrawIndexedIndirect(const VkBuffer buffer, const VkDeviceSize offset, const uint32_t draw_count = 1, const uint32_t stride = sizeof(VkDrawIndexedIndirectCommand)) noexcept;
+    void DrawIndirectCount(const VkBuffer buffer, const VkDeviceSize offset, const VkBuffer count_buffer, const VkDeviceSize count_offset, const uint32_t max_draw_count, const uint32_t stride = sizeof(VkDrawIndirectCommand));
+    void DrawIndexedIndirectCount(const VkBuffer buffer, const VkDeviceSize offset, const VkBuffer count_buffer, const VkDeviceSize count_offset, const uint32_t max_draw_count, const uint32_t stride = sizeof(VkDrawIndexedIndirectCommand));
+    void DispatchIndirect(const VkBuffer buffer, const VkDeviceSize offset = 0) noexcept;
+    static bool CheckIndirectRange(const BufferRange &range, const VkDeviceSize required) noexcept;
+    void DrawIndirect(const BufferRange &range, const uint32_t draw_count, const uint32_t stride) noexcept;
+    void DrawIndexedIndirect(const BufferRange &range, const uint32_t draw_count, const uint32_t stride) noexcept;
+    void DrawIndirectCount(const BufferRange &range, const BufferRange &count_range, const uint32_t max_draw_count, const uint32_t stride);
+    void DrawIndexedIndirectCount(const BufferRange &range, const BufferRange &count_range, const uint32_t max_draw_count, const uint32_t stride);
+    void DispatchIndirect(const BufferRange &range) noexcept;
+    void DispatchThreads(const uint32_t x, const uint32_t y, const uint32_t z) noexcept;
+    void SetWorkgroupSize(const WorkgroupSize size) noexcept { workgroup_size = size; }
 
     void BindPipeline(const VkPipeline pipeline, const VkPipelineBindPoint bind_point) noexcept;
+    void BindPipeline(const ComputePipeline &pipeline) noexcept;
+    void BindPipeline(const PipelineHandle &handle) noexcept;
+    void ResetQueryPool(const VkQueryPool query_pool, const uint32_t first_query, const uint32_t query_count) noexcept;
+    void WriteTimestamp(const VkQueryPool query_pool, const uint32_t query, const VkPipelineStageFlagBits stage) noexcept;
+    void PushConstants(const VkPipelineLayout pipeline_layout, const VkShaderStageFlags stages, const void *data, const uint32_t size, const uint32_t offset = 0) noexcept;
     void BindDescriptorSets(const VkPipelineLayout pipeline_layout, const VkPipelineBindPoint bind_point, const std::vector<VkDescriptorSet> sets, const uint32_t first_set, const std::vector<uint32_t> dynamic_offeset) noexcept;
     void BindVertexBuffers(const std::vector<VkBuffer> buffers, const std::vector<VkDeviceSize> offsets, const uint32_t first_binding, const uint32_t binding_count) noexcept;
     void BindIndexBuffer(const VkBuffer buffer, const VkIndexType index_type, const VkDeviceSize offset = 0) noexcept;
@@ -76,6 +102,8 @@ namespace Vulkan
 
     void CopyBufferToImage(const VkBuffer src, ImageArray &image, const size_t image_index, const std::vector<VkBufferImageCopy> regions) noexcept;
     void CopyBufferToBuffer(const VkBuffer src, const VkBuffer dst, std::vector<VkBufferCopy> regions) noexcept;
+    void FillBuffer(const VkBuffer dst, const VkDeviceSize offset, const VkDeviceSize size, const uint32_t data) noexcept;
+    void ComputeBarrier() noexcept;
   };
   
   class CommandBuffer
@@ -98,11 +126,11 @@ namespace Vulkan
     bool IsError() const noexcept { return !impl.get() || impl->IsError(); }
     bool IsReady() const noexcept { return impl.get() && impl->IsReady(); }
     bool IsReset() const noexcept { return impl.get() && impl->IsReset(); }
-    VkResult ExecuteBuffer(const uint32_t family_queue_index, VkFence exec_fence, std::vector<VkSemaphore> signal_semaphores, const std::vector<VkPipelineStageFlags> wait_dst_stages, const std::vector<VkSemaphore> wait_semaphores) { if (impl.get()) return impl->ExecuteBuffer(family_queue_index, exec_fence, signal_semaphores, wait_dst_stages, wait_semaphores); return VK_ERROR_UNKNOWN; }
+    VkResult ExecuteBuffer(const uint32_t family_queue_index, const uint32_t queue_index, VkFence exec_fence, std::vector<VkSemaphore> signal_semaphores, const std::vector<VkPipelineStageFlags> wait_dst_stages, const std::vector<VkSemaphore> wait_semaphores, const std::vector<uint64_t> signal_values = {}, const std::vector<uint64_t> wait_values = {}) { if (impl.get()) return impl->ExecuteBuffer(family_queue_index, queue_index, exec_fence, signal_semaphores, wait_dst_stages, wait_semaphores, signal_values, wait_values); return VK_ERROR_UNKNOWN; }
     void ResetCommandBuffer() { if (impl.get()) impl->ResetCommandBuffer(); }
     VkCommandBuffer GetBuffer() const noexcept { if (impl.get()) return impl->GetBuffer(); return VK_NULL_HANDLE; }
     std::shared_ptr<Device> GetDevice() const noexcept { if (impl.get()) return impl->GetDevice(); return nullptr; }
-    auto &BeginCommandBuffer() { if (impl.get()) impl->BeginCommandBuffer(); return *this; }
+    auto &BeginCommandBuffer(const VkCommandBufferUsageFlags usage_flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT) { if (impl.get()) impl->BeginCommandBuffer(usage_flags); return *this; }
     auto &EndCommandBuffer() { if (impl.get()) impl->EndCommandBuffer(); return *this; }
     auto &BeginRenderPass(const std::shared_ptr<Vulkan::RenderPass> render_pass, const uint32_t frame_buffer_index, const VkOffset2D offset = {0, 0}) { if (impl.get()) impl->BeginRenderPass(render_pass, frame_buffer_index, offset); return *this; }
     auto &EndRenderPass() noexcept { if (impl.get()) impl->EndRenderPass(); return *this; }
@@ -110,7 +138,26 @@ namespace Vulkan
     auto &DrawIndexed(const uint32_t index_count, const uint32_t first_index, const uint32_t vertex_offset = 0, const uint32_t instance_count = 1, const uint32_t first_instance = 0) noexcept { if (impl.get()) impl->DrawIndexed(index_count, first_index, vertex_offset, instance_count, first_instance); return *this; }
     auto &Draw(const uint32_t vertex_count, const uint32_t first_vertex = 0, const uint32_t instance_count = 1, const uint32_t first_instance = 0) noexcept { if (impl.get()) impl->Draw(vertex_count, first_vertex, instance_count, first_instance); return *this; }
     auto &Dispatch(const uint32_t x, const uint32_t y, const uint32_t z) noexcept { if (impl.get()) impl->Dispatch(x, y, z); return *this; }
+    auto &DrawIndirect(const VkBuffer buffer, const VkDeviceSize offset, const uint32_t draw_count = 1, const uint32_t stride = sizeof(VkDrawIndirectCommand)) noexcept { if (impl.get()) impl->DrawIndirect(buffer, offset, draw_count, stride); return *this; }
+    auto &DrawIndexedIndirect(const VkBuffer buffer, const VkDeviceSize offset, const uint32_t draw_count = 1, const uint32_t stride = sizeof(VkDrawIndexedIndirectCommand)) noexcept { if (impl.get()) impl->DrawIndexedIndirect(buffer, offset, draw_count, stride); return *this; }
+    auto &DrawIndirectCount(const VkBuffer buffer, const VkDeviceSize offset, const VkBuffer count_buffer, const VkDeviceSize count_offset, const uint32_t max_draw_count, const uint32_t stride = sizeof(VkDrawIndirectCommand)) { if (impl.get()) impl->DrawIndirectCount(buffer, offset, count_buffer, count_offset, max_draw_count, stride); return *this; }
+    auto &DrawIndexedIndirectCount(const VkBuffer buffer, const VkDeviceSize offset, const VkBuffer count_buffer, const VkDeviceSize count_offset, const uint32_t max_draw_count, const uint32_t stride = sizeof(VkDrawIndexedIndirectCommand)) { if (impl.get()) impl->DrawIndexedIndirectCount(buffer, offset, count_buffer, count_offset, max_draw_count, stride); return *this; }
+    auto &DispatchIndirect(const VkBuffer buffer, const VkDeviceSize offset = 0) noexcept { if (impl.get()) impl->DispatchIndirect(buffer, offset); return *this; }
+    auto &DrawIndirect(const BufferRange &range, const uint32_t draw_count = 1, const uint32_t stride = sizeof(VkDrawIndirectCommand)) noexcept { if (impl.get()) impl->DrawIndirect(range, draw_count, stride); return *this; }
+    auto &DrawIndexedIndirect(const BufferRange &range, const uint32_t draw_count = 1, const uint32_t stride = sizeof(VkDrawIndexedIndirectCommand)) noexcept { if (impl.get()) impl->DrawIndexedIndirect(range, draw_count, stride); return *this; }
+    auto &DrawIndirectCount(const BufferRange &range, const BufferRange &count_range, const uint32_t max_draw_count, const uint32_t stride = sizeof(VkDrawIndirectCommand)) { if (impl.get()) impl->DrawIndirectCount(range, count_range, max_draw_count, stride); return *this; }
+    auto &DrawIndexedIndirectCount(const BufferRange &range, const BufferRange &count_range, const uint32_t max_draw_count, const uint32_t stride = sizeof(VkDrawIndexedIndirectCommand)) { if (impl.get()) impl->DrawIndexedIndirectCount(range, count_range, max_draw_count, stride); return *this; }
+    auto &DispatchIndirect(const BufferRange &range) noexcept { if (impl.get()) impl->DispatchIndirect(range); return *this; }
+    auto &DispatchIndirect(const StorageArray &array, const size_t index, const size_t sub_index) { if (impl.get()) impl->DispatchIndirect(BufferRange::FromSubBuffer(array, index, sub_index)); return *this; }
+    auto &DispatchThreads(const uint32_t x, const uint32_t y = 1, const uint32_t z = 1) noexcept { if (impl.get()) impl->DispatchThreads(x, y, z); return *this; }
+    auto &SetWorkgroupSize(const WorkgroupSize size) noexcept { if (impl.get()) impl->SetWorkgroupSize(size); return *this; }
     auto &BindPipeline(const VkPipeline pipeline, const VkPipelineBindPoint bind_point) noexcept { if (impl.get()) impl->BindPipeline(pipeline, bind_point); return *this; }
+    auto &BindPipeline(const ComputePipeline &pipeline) noexcept { if (impl.get()) impl->BindPipeline(pipeline); return *this; }
+    auto &BindPipeline(const PipelineHandle &handle) noexcept { if (impl.get()) impl->BindPipeline(handle); return *this; }
+    auto &ResetQueryPool(const VkQueryPool query_pool, const uint32_t first_query, const uint32_t query_count) noexcept { if (impl.get()) impl->ResetQueryPool(query_pool, first_query, query_count); return *this; }
+    auto &WriteTimestamp(const VkQueryPool query_pool, const uint32_t query, const VkPipelineStageFlagBits stage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT) noexcept { if (impl.get()) impl->WriteTimestamp(query_pool, query, stage); return *this; }
+    auto &PushConstants(const VkPipelineLayout pipeline_layout, const VkShaderStageFlags stages, const void *data, const uint32_t size, const uint32_t offset = 0) noexcept { if (impl.get()) impl->PushConstants(pipeline_layout, stages, data, size, offset); return *this; }
+    template <typename T> auto &PushConstants(const VkPipelineLayout pipeline_layout, const VkShaderStageFlags stages, const T &data, const uint32_t offset = 0) noexcept { return PushConstants(pipeline_layout, stages, &data, (uint32_t) sizeof(T), offset); }
     auto &BindDescriptorSets(const VkPipelineLayout pipeline_layout, const VkPipelineBindPoint bind_point, const std::vector<VkDescriptorSet> sets, const uint32_t first_set, const std::vector<uint32_t> dynamic_offeset) noexcept { if (impl.get()) impl->BindDescriptorSets(pipeline_layout, bind_point, sets, first_set, dynamic_offeset); return *this; }
     auto &BindVertexBuffers(const std::vector<VkBuffer> buffers, const std::vector<VkDeviceSize> offsets, const uint32_t first_binding, const uint32_t binding_count) noexcept { if (impl.get()) impl->BindVertexBuffers(buffers, offsets, first_binding, binding_count); return *this; }
     auto &BindIndexBuffer(const VkBuffer buffer, const VkIndexType index_type, const VkDeviceSize offset = 0) noexcept { if (impl.get()) impl->BindIndexBuffer(buffer, index_type, offset); return *this; }
@@ -120,6 +167,8 @@ namespace Vulkan
     auto &ImageLayoutTransition(ImageArray &image, const size_t image_index, const VkImageLayout new_layout, const uint32_t mip_level = 0, const bool transit_all_mip_levels = true) { if (impl.get()) impl->ImageLayoutTransition(image, image_index, new_layout, mip_level, transit_all_mip_levels); return *this; }
     auto &CopyBufferToImage(const VkBuffer src, ImageArray &image, const size_t image_index, const std::vector<VkBufferImageCopy> regions) noexcept { if (impl.get()) impl->CopyBufferToImage(src, image, image_index, regions); return *this; }
     auto &CopyBufferToBuffer(const VkBuffer src, const VkBuffer dst, std::vector<VkBufferCopy> regions) noexcept { if (impl.get()) impl->CopyBufferToBuffer(src, dst, regions); return *this; }
+    auto &FillBuffer(const VkBuffer dst, const VkDeviceSize offset, const VkDeviceSize size, const uint32_t data = 0) noexcept { if (impl.get()) impl->FillBuffer(dst, offset, size, data); return *this; }
+    auto &ComputeBarrier() noexcept { if (impl.get()) impl->ComputeBarrier(); return *this; }
   };
 
   void swap(CommandBuffer &lhs, CommandBuffer &rhs) noexcept;
@@ -17,7 +17,7 @@ namespace Vulkan
     }
   }
 
-  CommandPool_impl::CommandPool_impl(std::shared_ptr<Device> dev, const uint32_t family_queue_index)
+  CommandPool_impl::CommandPool_impl(std::shared_ptr<Device> dev, const uint32_t family_queue_index, const uint32_t queue_index, const VkCommandPoolCreateFlags flags)
   {
     if (dev.get() == nullptr || dev->GetDevice() == VK_NULL_HANDLE)
     {
@@ -25,9 +25,15 @@ namespace Vulkan
       return;
     }
 
+    if (queue_index >= dev->GetFamilyQueuesCount(family_queue_index))
+    {
+      Logger::EchoError("Queue index is out of range", __func__);
+      return;
+    }
+
     VkCommandPoolCreateInfo command_pool_create_info = {};
     command_pool_create_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-    command_pool_create_info.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    command_pool_create_info.flags = flags;
     command_pool_create_info.queueFamilyIndex = family_queue_index;
 
     auto er = vkCreateCommandPool(dev->GetDevice(), &command_pool_create_info, nullptr, &command_pool);
@@ -40,6 +46,8 @@ namespace Vulkan
 
     device = dev;
     this->family_queue_index = family_queue_index;
+    this->queue_index = queue_index;
+    this->flags = flags;
   }
 
   CommandBuffer &CommandPool_impl::GetCommandBuffer(const uint32_t buffer_index, const VkCommandBufferLevel new_buffer_level)
@@ -60,17 +68,72 @@ namespace Vulkan
     }
   }
 
+  CommandBuffer &CommandPool_impl::NextCommandBuffer(const VkCommandBufferLevel new_buffer_level)
+  {
+    if (next_buffer < command_buffers.size() && command_buffers[next_buffer].impl->level != new_buffer_level)
+    {
+      Logger::EchoError("Command buffer level does not match", __func__);
+      return dummy_buffer;
+    }
+
+    return GetCommandBuffer((uint32_t) next_buffer++, new_buffer_level);
+  }
+
   void CommandPool_impl::ResetCommandBuffer(const uint32_t buffer_index)
   {
+    if (!(flags & VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT))
+    {
+      Logger::EchoError("Pool does not allow to reset single buffers", __func__);
+      return;
+    }
+
     if (buffer_index < command_buffers.size())
     {
       command_buffers[buffer_index].ResetCommandBuffer();
     }
   }
 
+  VkResult CommandPool_impl::Reset(const bool release_resources)
+  {
+    if (device.get() == nullptr || command_pool == VK_NULL_HANDLE)
+    {
+      Logger::EchoError("Command pool is empty", __func__);
+      return VK_ERROR_UNKNOWN;
+    }
+
+    VkCommandPoolResetFlags reset_flags = release_resources ? VK_COMMAND_POOL_RESET_RELEASE_RESOURCES_BIT : 0;
+    if (auto er = vkResetCommandPool(device->GetDevice(), command_pool, reset_flags); er != VK_SUCCESS)
+    {
+      Logger::EchoError("Failed to reset command pool", __func__);
+      Logger::EchoDebug("Return code = " + std::to_string(er), __func__);
+      return er;
+    }
+
+    for (auto &b : command_buffers)
+      b.impl->MarkAsReset();
+    next_buffer = 0;
+
+    return VK_SUCCESS;
+  }
+
   void CommandPool_impl::PopLastCommandBuffer() noexcept
   {
     command_buffers.pop_back();
+    next_buffer = std::min(next_buffer, command_buffers.size());
+  }
+
+  std::optional<uint32_t> CommandPool_impl::GetCommandBufferIndex(const VkCommandBuffer buffer) const noexcept
+  {
+    if (buffer == VK_NULL_HANDLE)
+      return {};
+
+    for (size_t i = 0; i < command_buffers.size(); ++i)
+    {
+      if (command_buffers[i].GetBuffer() == buffer)
+        return (uint32_t) i;
+    }
+
+    return {};
   }
 
   bool CommandPool_impl::IsError(const uint32_t buffer_index) const noexcept
@@ -103,7 +166,7 @@ namespace Vulkan
     return true;
   }
 
-  VkResult CommandPool_impl::ExecuteBuffer(const uint32_t buffer_index, VkFence exec_fence, std::vector<VkSemaphore> signal_semaphores, const std::vector<VkPipelineStageFlags> wait_dst_stages, const std::vector<VkSemaphore> wait_semaphores)
+  VkResult CommandPool_impl::ExecuteBuffer(const uint32_t buffer_index, VkFence exec_fence, std::vector<VkSemaphore> signal_semaphores, const std::vector<VkPipelineStageFlags> wait_dst_stages, const std::vector<VkSemaphore> wait_semaphores, const std::vector<uint64_t> signal_values, const std::vector<uint64_t> wait_values)
   {
     if (command_buffers.size() <= buffer_index || !command_buffers[buffer_index].IsReady())
     {
@@ -111,7 +174,7 @@ namespace Vulkan
       return VK_ERROR_UNKNOWN;
     }
     
-    return command_buffers[buffer_index].ExecuteBuffer(family_queue_index, exec_fence, signal_semaphores, wait_dst_stages, wait_semaphores);
+    return command_buffers[buffer_index].ExecuteBuffer(family_queue_index, queue_index, exec_fence, signal_semaphores, wait_dst_stages, wait_semaphores, signal_values, wait_values);
   }
 
   CommandPool &CommandPool::operator=(CommandPool &&obj) noexcept
@@ -135,4 +198,157 @@ namespace Vulkan
 
     lhs.swap(rhs);
   }
+
+  FrameCommandPools_impl::~FrameCommandPools_impl() noexcept
+  {
+    Logger::EchoDebug("", __func__);
+    if (frame_started)
+    {
+      VkQueue queue = device->GetQueue(family_queue_index, queue_index);
+      if (vkQueueSubmit(queue, 0, nullptr, fences[frame_index].GetFence()) != VK_SUCCESS)
+      {
+        vkQueueWaitIdle(queue);
+        return;
+      }
+    }
+
+    for (auto &f : fences)
+      f.Wait();
+  }
+
+  FrameCommandPools_impl::FrameCommandPools_impl(std::shared_ptr<Device> dev, const uint32_t family_queue_index, const size_t frames_in_flight, const uint32_t queue_index)
+  {
+    if (dev.get() == nullptr || dev->GetDevice() == VK_NULL_HANDLE)
+    {
+      Logger::EchoError("Device is empty", __func__);
+      return;
+    }
+
+    if (frames_in_flight == 0)
+    {
+      Logger::EchoError("Frames count must be greater than zero", __func__);
+      return;
+    }
+
+    std::vector<CommandPool> tmp_pools;
+    std::vector<Fence> tmp_fences;
+    for (size_t i = 0; i < frames_in_flight; ++i)
+    {
+      CommandPool pool(dev, family_queue_index, queue_index, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+      Fence fence(dev, VK_FENCE_CREATE_SIGNALED_BIT);
+      if (!pool.IsValid() || !fence.IsValid())
+      {
+        Logger::EchoError("Can't create frame resources", __func__);
+        return;
+      }
+      tmp_pools.push_back(std::move(pool));
+      tmp_fences.push_back(std::move(fence));
+    }
+
+    device = dev;
+    pools = std::move(tmp_pools);
+    fences = std::move(tmp_fences);
+    this->family_queue_index = family_queue_index;
+    this->queue_index = queue_index;
+  }
+
+  VkResult FrameCommandPools_impl::BeginFrame(const uint64_t timeout)
+  {
+    if (frame_started)
+    {
+      Logger::EchoError("Frame is already started", __func__);
+      return VK_ERROR_UNKNOWN;
+    }
+
+    if (auto er = fences[frame_index].Wait(timeout); er != VK_SUCCESS)
+      return er;
+
+    if (auto er = pools[frame_index].Reset(); er != VK_SUCCESS)
+      return er;
+
+    if (auto er = fences[frame_index].Reset(); er != VK_SUCCESS)
+    {
+      Logger::EchoError("Failed to reset fence", __func__);
+      return er;
+    }
+
+    frame_started = true;
+    return VK_SUCCESS;
+  }
+
+  VkResult FrameCommandPools_impl::EndFrame()
+  {
+    if (!frame_started)
+    {
+      Logger::EchoError("Frame is not started", __func__);
+      return VK_ERROR_UNKNOWN;
+    }
+
+    VkQueue queue = device->GetQueue(family_queue_index, queue_index);
+    if (auto er = vkQueueSubmit(queue, 0, nullptr, fences[frame_index].GetFence()); er != VK_SUCCESS)
+    {
+      Logger::EchoError("Failed to submit frame fence", __func__);
+      Logger::EchoDebug("Return code = " + std::to_string(er), __func__);
+      return er;
+    }
+
+    frame_started = false;
+    frame_index = (frame_index + 1) % pools.size();
+    return VK_SUCCESS;
+  }
+
+  VkResult FrameCommandPools_impl::ExecuteBuffer(const uint32_t buffer_index,
+                                                 std::vector<VkSemaphore> signal_semaphores,
+                                                 const std::vector<VkPipelineStageFlags> wait_dst_stages,
+                                                 const std::vector<VkSemaphore> wait_semaphores,
+                                                 const std::vector<uint64_t> signal_values,
+                                                 const std::vector<uint64_t> wait_values)
+  {
+    if (!frame_started)
+    {
+      Logger::EchoError("Frame is not started", __func__);
+      return VK_ERROR_UNKNOWN;
+    }
+
+    return pools[frame_index].ExecuteBuffer(buffer_index, VK_NULL_HANDLE, signal_semaphores, wait_dst_stages, wait_semaphores, signal_values, wait_values);
+  }
+
+  VkResult FrameCommandPools_impl::ExecuteBuffer(const CommandBuffer &buffer,
+                                                 std::vector<VkSemaphore> signal_semaphores,
+                                                 const std::vector<VkPipelineStageFlags> wait_dst_stages,
+                                                 const std::vector<VkSemaphore> wait_semaphores,
+                                                 const std::vector<uint64_t> signal_values,
+                                                 const std::vector<uint64_t> wait_values)
+  {
+    auto index = pools[frame_index].GetCommandBufferIndex(buffer);
+    if (!index.has_value())
+    {
+      Logger::EchoError("Command buffer does not belong to the current frame", __func__);
+      return VK_ERROR_UNKNOWN;
+    }
+
+    return ExecuteBuffer(index.value(), signal_semaphores, wait_dst_stages, wait_semaphores, signal_values, wait_values);
+  }
+
+  FrameCommandPools &FrameCommandPools::operator=(FrameCommandPools &&obj) noexcept
+  {
+    if (&obj == this) return *this;
+
+    impl = std::move(obj.impl);
+    return *this;
+  }
+
+  void FrameCommandPools::swap(FrameCommandPools &obj) noexcept
+  {
+    if (&obj == this) return;
+
+    impl.swap(obj.impl);
+  }
+
+  void swap(FrameCommandPools &lhs, FrameCommandPools &rhs) noexcept
+  {
+    if (&lhs == &rhs) return;
+
+    lhs.swap(rhs);
+  }
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "Logger.h"
 #include "Device.h"
 #include "CommandBuffer.h"
+#include "Fence.h"
 
 #include <vulkan/vulkan.h>
 #include <memory>
@@ -27,25 +28,35 @@ namespace Vulkan
     std::shared_ptr<Device> device;
     VkCommandPool command_pool = VK_NULL_HANDLE;
     uint32_t family_queue_index = 0;
+    uint32_t queue_index = 0;
+    VkCommandPoolCreateFlags flags = 0;
+    size_t next_buffer = 0;
     std::vector<CommandBuffer> command_buffers;
     CommandBuffer dummy_buffer;
 
-    CommandPool_impl(std::shared_ptr<Device> dev, const uint32_t family_queue_index);
+    CommandPool_impl(std::shared_ptr<Device> dev, const uint32_t family_queue_index, const uint32_t queue_index, const VkCommandPoolCreateFlags flags);
     VkCommandPool GetCommandPool() const noexcept { return command_pool; }
     size_t GetCommandBuffersCount() const noexcept { return command_buffers.size(); }
+    size_t GetUsedCommandBuffersCount() const noexcept { return next_buffer; }
     CommandBuffer &GetCommandBuffer(const uint32_t buffer_index, const VkCommandBufferLevel new_buffer_level = VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+    CommandBuffer &NextCommandBuffer(const VkCommandBufferLevel new_buffer_level);
     void ResetCommandBuffer(const uint32_t buffer_index);
+    VkResult Reset(const bool release_resources);
     void PopLastCommandBuffer() noexcept;
+    std::optional<uint32_t> GetCommandBufferIndex(const VkCommandBuffer buffer) const noexcept;
     VkResult ExecuteBuffer(const uint32_t buffer_index,
                            VkFence exec_fence,
                            std::vector<VkSemaphore> signal_semaphores, 
                            const std::vector<VkPipelineStageFlags> wait_dst_stages, 
-                           const std::vector<VkSemaphore> wait_semaphores);
+                           const std::vector<VkSemaphore> wait_semaphores,
+                           const std::vector<uint64_t> signal_values,
+                           const std::vector<uint64_t> wait_values);
     bool IsError(const uint32_t buffer_index) const noexcept;
     bool IsReady(const uint32_t buffer_index) const noexcept;
     bool IsReset(const uint32_t buffer_index) const noexcept;
     std::shared_ptr<Device> GetDevice() const noexcept { return device; }
     uint32_t GetFamilyQueueIndex() const noexcept { return family_queue_index; }
+    uint32_t GetQueueIndex() const noexcept { return queue_index; }
   };
 
   class CommandPool
@@ -57,8 +68,8 @@ namespace Vulkan
     CommandPool() = delete;
     CommandPool(const CommandPool &obj) = delete;
     CommandPool(CommandPool &&obj) noexcept : impl(std::move(obj.impl)) {};
-    CommandPool(std::shared_ptr<Device> dev, const uint32_t family_queue_index) : 
-      impl(std::unique_ptr<CommandPool_impl>(new CommandPool_impl(dev, family_queue_index))) {};
+    CommandPool(std::shared_ptr<Device> dev, const uint32_t family_queue_index, const uint32_t queue_index = 0, const VkCommandPoolCreateFlags flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT) : 
+      impl(std::unique_ptr<CommandPool_impl>(new CommandPool_impl(dev, family_queue_index, queue_index, flags))) {};
     CommandPool &operator=(const CommandPool &obj) = delete;
     CommandPool &operator=(CommandPool &&obj) noexcept;
     ~CommandPool() noexcept = default;
@@ -67,18 +78,93 @@ namespace Vulkan
 
     VkCommandPool GetCommandPool() const noexcept { if (impl.get()) return impl->GetCommandPool(); return VK_NULL_HANDLE; }
     size_t GetCommandBuffersCount() const noexcept { if (impl.get()) return impl->GetCommandBuffersCount(); return 0; }
+    size_t GetUsedCommandBuffersCount() const noexcept { if (impl.get()) return impl->GetUsedCommandBuffersCount(); return 0; }
     CommandBuffer& GetCommandBuffer(const uint32_t buffer_index, const VkCommandBufferLevel new_buffer_level = VK_COMMAND_BUFFER_LEVEL_PRIMARY) { if (impl.get()) return impl->GetCommandBuffer(buffer_index, new_buffer_level); return dummy_buffer; }
+    CommandBuffer& NextCommandBuffer(const VkCommandBufferLevel new_buffer_level = VK_COMMAND_BUFFER_LEVEL_PRIMARY) { if (impl.get()) return impl->NextCommandBuffer(new_buffer_level); return dummy_buffer; }
     void ResetCommandBuffer(const uint32_t buffer_index) { if (impl.get()) impl->ResetCommandBuffer(buffer_index); }
+    VkResult Reset(const bool release_resources = false) { if (IsValid()) return impl->Reset(release_resources); return VK_ERROR_UNKNOWN; }
     void PopLastCommandBuffer() noexcept { if (impl.get()) impl->PopLastCommandBuffer(); }
-    VkResult ExecuteBuffer(const uint32_t buffer_index, VkFence exec_fence = VK_NULL_HANDLE, std::vector<VkSemaphore> signal_semaphores = {}, const std::vector<VkPipelineStageFlags> wait_dst_stages = {}, const std::vector<VkSemaphore> wait_semaphores = {}) { if (impl.get()) return impl->ExecuteBuffer(buffer_index, exec_fence, signal_semaphores, wait_dst_stages, wait_semaphores); return VK_ERROR_UNKNOWN; }
+    std::optional<uint32_t> GetCommandBufferIndex(const CommandBuffer &buffer) const noexcept { if (impl.get()) return impl->GetCommandBufferIndex(buffer.GetBuffer()); return {}; }
+    VkResult ExecuteBuffer(const uint32_t buffer_index, VkFence exec_fence = VK_NULL_HANDLE, std::vector<VkSemaphore> signal_semaphores = {}, const std::vector<VkPipelineStageFlags> wait_dst_stages = {}, const std::vector<VkSemaphore> wait_semaphores = {}, const std::vector<uint64_t> signal_values = {}, const std::vector<uint64_t> wait_values = {}) { if (impl.get()) return impl->ExecuteBuffer(buffer_index, exec_fence, signal_semaphores, wait_dst_stages, wait_semaphores, signal_values, wait_values); return VK_ERROR_UNKNOWN; }
     bool IsError(const uint32_t buffer_index) const noexcept { if (impl.get()) return impl->IsError(buffer_index); return true; }
     bool IsReady(const uint32_t buffer_index) const noexcept { if (impl.get()) return impl->IsReady(buffer_index); return false; }
     bool IsReset(const uint32_t buffer_index) const noexcept { if (impl.get()) return impl->IsReset(buffer_index); return true; }
     std::shared_ptr<Device> GetDevice() const noexcept { if (impl.get()) return impl->GetDevice(); return nullptr; }
     std::optional<uint32_t> GetFamilyQueueIndex() const noexcept { if (impl.get()) return impl->GetFamilyQueueIndex(); return {}; }
+    std::optional<uint32_t> GetQueueIndex() const noexcept { if (impl.get()) return impl->GetQueueIndex(); return {}; }
+  };
+
+  class FrameCommandPools_impl
+  {
+  public:
+    FrameCommandPools_impl() = delete;
+    FrameCommandPools_impl(const FrameCommandPools_impl &obj) = delete;
+    FrameCommandPools_impl(FrameCommandPools_impl &&obj) = delete;
+    FrameCommandPools_impl &operator=(const FrameCommandPools_impl &obj) = delete;
+    FrameCommandPools_impl &operator=(FrameCommandPools_impl &&obj) = delete;
+    ~FrameCommandPools_impl() noexcept;
+  private:
+    friend class FrameCommandPools;
+    std::shared_ptr<Device> device;
+    std::vector<CommandPool> pools;
+    std::vector<Fence> fences;
+    uint32_t family_queue_index = 0;
+    uint32_t queue_index = 0;
+    size_t frame_index = 0;
+    bool frame_started = false;
+
+    FrameCommandPools_impl(std::shared_ptr<Device> dev, const uint32_t family_queue_index, const size_t frames_in_flight, const uint32_t queue_index);
+    VkResult BeginFrame(const uint64_t timeout);
+    VkResult EndFrame();
+    VkResult ExecuteBuffer(const uint32_t buffer_index,
+                           std::vector<VkSemaphore> signal_semaphores,
+                           const std::vector<VkPipelineStageFlags> wait_dst_stages,
+                           const std::vector<VkSemaphore> wait_semaphores,
+                           const std::vector<uint64_t> signal_values,
+                           const std::vector<uint64_t> wait_values);
+    VkResult ExecuteBuffer(const CommandBuffer &buffer,
+                           std::vector<VkSemaphore> signal_semaphores,
+                           const std::vector<VkPipelineStageFlags> wait_dst_stages,
+                           const std::vector<VkSemaphore> wait_semaphores,
+                           const std::vector<uint64_t> signal_values,
+                           const std::vector<uint64_t> wait_values);
+    CommandPool &GetCurrentPool() noexcept { return pools[frame_index]; }
+    VkFence GetCurrentFence() const noexcept { return fences[frame_index].GetFence(); }
+    size_t GetFrameIndex() const noexcept { return frame_index; }
+    size_t GetFramesCount() const noexcept { return pools.size(); }
+    std::shared_ptr<Device> GetDevice() const noexcept { return device; }
+  };
+
+  class FrameCommandPools
+  {
+  private:
+    std::unique_ptr<FrameCommandPools_impl> impl;
+    CommandBuffer dummy_buffer;
+  public:
+    FrameCommandPools() = delete;
+    FrameCommandPools(const FrameCommandPools &obj) = delete;
+    FrameCommandPools(FrameCommandPools &&obj) noexcept : impl(std::move(obj.impl)) {};
+    FrameCommandPools(std::shared_ptr<Device> dev, const uint32_t family_queue_index, const size_t frames_in_flight = 2, const uint32_t queue_index = 0) :
+      impl(std::unique_ptr<FrameCommandPools_impl>(new FrameCommandPools_impl(dev, family_queue_index, frames_in_flight, queue_index))) {};
+    FrameCommandPools &operator=(const FrameCommandPools &obj) = delete;
+    FrameCommandPools &operator=(FrameCommandPools &&obj) noexcept;
+    ~FrameCommandPools() noexcept = default;
+    void swap(FrameCommandPools &obj) noexcept;
+    bool IsValid() const noexcept { return impl.get() && !impl->pools.empty(); }
+
+    VkResult BeginFrame(const uint64_t timeout = UINT64_MAX) { if (impl.get()) return impl->BeginFrame(timeout); return VK_ERROR_UNKNOWN; }
+    VkResult EndFrame() { if (impl.get()) return impl->EndFrame(); return VK_ERROR_UNKNOWN; }
+    CommandBuffer &NextCommandBuffer(const VkCommandBufferLevel new_buffer_level = VK_COMMAND_BUFFER_LEVEL_PRIMARY) { if (IsValid()) return impl->GetCurrentPool().NextCommandBuffer(new_buffer_level); return dummy_buffer; }
+    VkResult ExecuteBuffer(const uint32_t buffer_index, std::vector<VkSemaphore> signal_semaphores = {}, const std::vector<VkPipelineStageFlags> wait_dst_stages = {}, const std::vector<VkSemaphore> wait_semaphores = {}, const std::vector<uint64_t> signal_values = {}, const std::vector<uint64_t> wait_values = {}) { if (IsValid()) return impl->ExecuteBuffer(buffer_index, signal_semaphores, wait_dst_stages, wait_semaphores, signal_values, wait_values); return VK_ERROR_UNKNOWN; }
+    VkResult ExecuteBuffer(const CommandBuffer &buffer, std::vector<VkSemaphore> signal_semaphores = {}, const std::vector<VkPipelineStageFlags> wait_dst_stages = {}, const std::vector<VkSemaphore> wait_semaphores = {}, const std::vector<uint64_t> signal_values = {}, const std::vector<uint64_t> wait_values = {}) { if (IsValid()) return impl->ExecuteBuffer(buffer, signal_semaphores, wait_dst_stages, wait_semaphores, signal_values, wait_values); return VK_ERROR_UNKNOWN; }
+    VkFence GetCurrentFence() const noexcept { if (IsValid()) return impl->GetCurrentFence(); return VK_NULL_HANDLE; }
+    std::optional<size_t> GetFrameIndex() const noexcept { if (impl.get()) return impl->GetFrameIndex(); return {}; }
+    size_t GetFramesCount() const noexcept { if (impl.get()) return impl->GetFramesCount(); return 0; }
+    std::shared_ptr<Device> GetDevice() const noexcept { if (impl.get()) return impl->GetDevice(); return nullptr; }
   };
 
   void swap(CommandPool &lhs, CommandPool &rhs) noexcept;
+  void swap(FrameCommandPools &lhs, FrameCommandPools &rhs) noexcept;
 }
 
 #endif
\ No newline at end of file
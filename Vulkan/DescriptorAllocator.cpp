@@ -0,0 +1,211 @@
+#include "DescriptorAllocator.h"
+
+namespace Vulkan
+{
+  DescriptorAllocator_impl::~DescriptorAllocator_impl() noexcept
+  {
+    Logger::EchoDebug("", __func__);
+    if (device == nullptr || device->GetDevice() == VK_NULL_HANDLE)
+      return;
+
+    for (auto &f : frames)
+    {
+      for (auto p : f.full)
+        vkDestroyDescriptorPool(device->GetDevice(), p, nullptr);
+      for (auto p : f.ready)
+        vkDestroyDescriptorPool(device->GetDevice(), p, nullptr);
+    }
+  }
+
+  DescriptorAllocator_impl::DescriptorAllocator_impl(std::shared_ptr<Device> dev, const DescriptorAllocatorConfig &params)
+  {
+    if (dev.get() == nullptr || !dev->IsValid())
+    {
+      Logger::EchoError("Device is empty", __func__);
+      return;
+    }
+
+    device = dev;
+    config = params;
+    if (config.ratios.empty())
+    {
+      config.AddPoolRatio(DescriptorType::BufferStorage, 4.0f)
+            .AddPoolRatio(DescriptorType::BufferUniform, 1.0f)
+            .AddPoolRatio(DescriptorType::BufferStorageDynamic, 1.0f)
+            .AddPoolRatio(DescriptorType::BufferUniformDynamic, 1.0f)
+            .AddPoolRatio(DescriptorType::TexelStorage, 1.0f)
+            .AddPoolRatio(DescriptorType::TexelUniform, 1.0f)
+            .AddPoolRatio(DescriptorType::ImageSamplerCombined, 2.0f)
+            .AddPoolRatio(DescriptorType::ImageStorage, 1.0f);
+    }
+
+    frames.resize(config.frames_count);
+    for (auto &f : frames)
+      f.sets_per_pool = config.sets_per_pool;
+  }
+
+  VkDescriptorPool DescriptorAllocator_impl::CreatePool(const uint32_t sets_count)
+  {
+    std::vector<VkDescriptorPoolSize> sizes;
+    sizes.reserve(config.ratios.size());
+    for (auto &r : config.ratios)
+      sizes.push_back({r.first, std::max(1u, (uint32_t) (r.second * sets_count))});
+
+    VkDescriptorPoolCreateInfo descriptor_pool_create_info = {};
+    descriptor_pool_create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    descriptor_pool_create_info.maxSets = sets_count;
+    descriptor_pool_create_info.pPoolSizes = sizes.data();
+    descriptor_pool_create_info.poolSizeCount = (uint32_t) sizes.size();
+
+    VkDescriptorPool result = VK_NULL_HANDLE;
+    if (auto er = vkCreateDescriptorPool(device->GetDevice(), &descriptor_pool_create_info, nullptr, &result); er != VK_SUCCESS)
+    {
+      Logger::EchoError("Can't create descriptor pool", __func__);
+      Logger::EchoDebug("Return code = " + std::to_string(er), __func__);
+      return VK_NULL_HANDLE;
+    }
+
+    return result;
+  }
+
+  VkDescriptorPool DescriptorAllocator_impl::GetPool(PoolChain &chain)
+  {
+    if (!chain.ready.empty())
+      return chain.ready.back();
+
+    auto pool = CreatePool(chain.sets_per_pool);
+    if (pool == VK_NULL_HANDLE)
+      return pool;
+
+    chain.sets_per_pool = std::min(chain.sets_per_pool * 2, config.max_sets_per_pool);
+    chain.ready.push_back(pool);
+    return pool;
+  }
+
+  VkResult DescriptorAllocator_impl::Allocate(const VkDescriptorSetLayout layout, VkDescriptorSet &set)
+  {
+    if (layout == VK_NULL_HANDLE)
+    {
+      Logger::EchoError("Layout is empty", __func__);
+      return VK_ERROR_UNKNOWN;
+    }
+
+    std::lock_guard lock(alloc_mutex);
+    auto &chain = frames[frame_index];
+
+    VkDescriptorSetAllocateInfo alloc_info = {};
+    alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    alloc_info.descriptorSetCount = 1;
+    alloc_info.pSetLayouts = &layout;
+
+    for (size_t attempt = 0; attempt < 2; ++attempt)
+    {
+      bool fresh = chain.ready.empty();
+      alloc_info.descriptorPool = GetPool(chain);
+      if (alloc_info.descriptorPool == VK_NULL_HANDLE)
+        return VK_ERROR_OUT_OF_POOL_MEMORY;
+
+      auto er = vkAllocateDescriptorSets(device->GetDevice(), &alloc_info, &set);
+      if (er == VK_SUCCESS)
+        return er;
+
+      if (er != VK_ERROR_OUT_OF_POOL_MEMORY && er != VK_ERROR_FRAGMENTED_POOL)
+      {
+        Logger::EchoError("Failed to allocate descriptor set", __func__);
+        Logger::EchoDebug("Return code = " + std::to_string(er), __func__);
+        return er;
+      }
+
+      if (fresh)
+      {
+        Logger::EchoError("Layout doesn't fit into an empty pool", __func__);
+        return er;
+      }
+
+      chain.full.push_back(chain.ready.back());
+      chain.ready.pop_back();
+    }
+
+    Logger::EchoError("Layout doesn't fit into an empty pool", __func__);
+    return VK_ERROR_OUT_OF_POOL_MEMORY;
+  }
+
+  VkResult DescriptorAllocator_impl::Allocate(const VkDescriptorSetLayout layout, const LayoutConfig &info, VkDescriptorSet &set)
+  {
+    if (auto er = Allocate(layout, set); er != VK_SUCCESS)
+      return er;
+
+    return Descriptors_impl::WriteDescriptorSet(device->GetDevice(), set, info);
+  }
+
+  VkResult DescriptorAllocator_impl::ResetFrame(const size_t index, const VkFence fence)
+  {
+    if (index >= frames.size())
+    {
+      Logger::EchoError("Index is out off range", __func__);
+      return VK_ERROR_UNKNOWN;
+    }
+
+    if (fence != VK_NULL_HANDLE)
+    {
+      if (auto er = vkWaitForFences(device->GetDevice(), 1, &fence, VK_TRUE, UINT64_MAX); er != VK_SUCCESS)
+      {
+        Logger::EchoError("Failed to wait for frame fence", __func__);
+        return er;
+      }
+    }
+
+    std::lock_guard lock(alloc_mutex);
+    auto &chain = frames[index];
+    chain.ready.insert(chain.ready.end(), chain.full.begin(), chain.full.end());
+    chain.full.clear();
+
+    for (auto p : chain.ready)
+    {
+      if (auto er = vkResetDescriptorPool(device->GetDevice(), p, 0); er != VK_SUCCESS)
+      {
+        Logger::EchoError("Failed to reset descriptor pool", __func__);
+        return er;
+      }
+    }
+
+    return VK_SUCCESS;
+  }
+
+  VkResult DescriptorAllocator_impl::BeginFrame(const VkFence fence)
+  {
+    return ResetFrame(frame_index, fence);
+  }
+
+  size_t DescriptorAllocator_impl::GetPoolsCount()
+  {
+    std::lock_guard lock(alloc_mutex);
+    size_t result = 0;
+    for (auto &f : frames)
+      result += f.full.size() + f.ready.size();
+
+    return result;
+  }
+
+  DescriptorAllocator &DescriptorAllocator::operator=(DescriptorAllocator &&obj) noexcept
+  {
+    if (&obj == this) return *this;
+
+    impl = std::move(obj.impl);
+    return *this;
+  }
+
+  void DescriptorAllocator::swap(DescriptorAllocator &obj) noexcept
+  {
+    if (&obj == this) return;
+
+    impl.swap(obj.impl);
+  }
+
+  void swap(DescriptorAllocator &lhs, DescriptorAllocator &rhs) noexcept
+  {
+    if (&lhs == &rhs) return;
+
+    lhs.swap(rhs);
+  }
+}
\ No newline at end of file
@@ -0,0 +1,109 @@
+#ifndef __VULKAN_DESCRIPTOR_ALLOCATOR_H
+#define __VULKAN_DESCRIPTOR_ALLOCATOR_H
+
+#include "Logger.h"
+#include "Device.h"
+#include "Descriptors.h"
+
+#include <vulkan/vulkan.h>
+#include <memory>
+#include <vector>
+#include <mutex>
+
+namespace Vulkan
+{
+  class DescriptorAllocatorConfig
+  {
+  private:
+    friend class DescriptorAllocator_impl;
+    std::vector<std::pair<VkDescriptorType, float>> ratios;
+    uint32_t sets_per_pool = 64;
+    uint32_t max_sets_per_pool = 4096;
+    size_t frames_count = 1;
+  public:
+    DescriptorAllocatorConfig() = default;
+    ~DescriptorAllocatorConfig() noexcept = default;
+    auto &AddPoolRatio(const DescriptorType type, const float ratio)
+    {
+      if (ratio > 0.0f) ratios.push_back({(VkDescriptorType) type, ratio});
+      else Logger::EchoWarning("Ratio must be positive", __func__);
+      return *this;
+    }
+    auto &SetSetsPerPool(const uint32_t initial, const uint32_t max = 4096)
+    {
+      if (initial > 0) { sets_per_pool = initial; max_sets_per_pool = std::max(initial, max); }
+      return *this;
+    }
+    auto &SetFramesCount(const size_t count) { if (count > 0) frames_count = count; return *this; }
+  };
+
+  class DescriptorAllocator_impl
+  {
+  public:
+    DescriptorAllocator_impl() = delete;
+    DescriptorAllocator_impl(const DescriptorAllocator_impl &obj) = delete;
+    DescriptorAllocator_impl(DescriptorAllocator_impl &&obj) = delete;
+    DescriptorAllocator_impl &operator=(const DescriptorAllocator_impl &obj) = delete;
+    DescriptorAllocator_impl &operator=(DescriptorAllocator_impl &&obj) = delete;
+    ~DescriptorAllocator_impl() noexcept;
+  private:
+    friend class DescriptorAllocator;
+    struct PoolChain
+    {
+      std::vector<VkDescriptorPool> full;
+      std::vector<VkDescriptorPool> ready;
+      uint32_t sets_per_pool = 0;
+    };
+
+    std::shared_ptr<Device> device;
+    DescriptorAllocatorConfig config;
+    std::vector<PoolChain> frames;
+    size_t frame_index = 0;
+    std::mutex alloc_mutex;
+
+    DescriptorAllocator_impl(std::shared_ptr<Device> dev, const DescriptorAllocatorConfig &params);
+    VkDescriptorPool CreatePool(const uint32_t sets_count);
+    VkDescriptorPool GetPool(PoolChain &chain);
+    VkResult Allocate(const VkDescriptorSetLayout layout, VkDescriptorSet &set);
+    VkResult Allocate(const VkDescriptorSetLayout layout, const LayoutConfig &info, VkDescriptorSet &set);
+    VkResult ResetFrame(const size_t index, const VkFence fence);
+    VkResult BeginFrame(const VkFence fence);
+    void EndFrame() noexcept { frame_index = (frame_index + 1) % frames.size(); }
+    size_t GetPoolsCount();
+    size_t GetFrameIndex() const noexcept { return frame_index; }
+    size_t GetFramesCount() const noexcept { return frames.size(); }
+    std::shared_ptr<Device> GetDevice() const noexcept { return device; }
+  };
+
+  class DescriptorAllocator
+  {
+  private:
+    std::unique_ptr<DescriptorAllocator_impl> impl;
+  public:
+    DescriptorAllocator() = delete;
+    DescriptorAllocator(const DescriptorAllocator &obj) = delete;
+    DescriptorAllocator(DescriptorAllocator &&obj) noexcept : impl(std::move(obj.impl)) {};
+    DescriptorAllocator(std::shared_ptr<Device> dev, const DescriptorAllocatorConfig &params = {}) :
+      impl(std::unique_ptr<DescriptorAllocator_impl>(new DescriptorAllocator_impl(dev, params))) {};
+    DescriptorAllocator &operator=(const DescriptorAllocator &obj) = delete;
+    DescriptorAllocator &operator=(DescriptorAllocator &&obj) noexcept;
+    ~DescriptorAllocator() noexcept = default;
+    void swap(DescriptorAllocator &obj) noexcept;
+    bool IsValid() const noexcept { return impl.get() && !impl->frames.empty(); }
+
+    VkResult Allocate(const VkDescriptorSetLayout layout, VkDescriptorSet &set) { if (IsValid()) return impl->Allocate(layout, set); return VK_ERROR_UNKNOWN; }
+    VkResult Allocate(const VkDescriptorSetLayout layout, const LayoutConfig &info, VkDescriptorSet &set) { if (IsValid()) return impl->Allocate(layout, info, set); return VK_ERROR_UNKNOWN; }
+    // Without a fence the caller must have waited on the fence of the frame being reset
+    VkResult BeginFrame(const VkFence fence = VK_NULL_HANDLE) { if (IsValid()) return impl->BeginFrame(fence); return VK_ERROR_UNKNOWN; }
+    void EndFrame() noexcept { if (IsValid()) impl->EndFrame(); }
+    VkResult ResetFrame(const size_t index, const VkFence fence = VK_NULL_HANDLE) { if (IsValid()) return impl->ResetFrame(index, fence); return VK_ERROR_UNKNOWN; }
+    size_t GetPoolsCount() { if (impl.get()) return impl->GetPoolsCount(); return 0; }
+    size_t GetFrameIndex() const noexcept { if (impl.get()) return impl->GetFrameIndex(); return 0; }
+    size_t GetFramesCount() const noexcept { if (impl.get()) return impl->GetFramesCount(); return 0; }
+    std::shared_ptr<Device> GetDevice() const noexcept { if (impl.get()) return impl->GetDevice(); return nullptr; }
+  };
+
+  void swap(DescriptorAllocator &lhs, DescriptorAllocator &rhs) noexcept;
+}
+
+#endif
\ No newline at end of file
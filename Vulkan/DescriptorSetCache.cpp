@@ -0,0 +1,181 @@
+#include "DescriptorSetCache.h"
+
+namespace Vulkan
+{
+  DescriptorSetCache_impl::~DescriptorSetCache_impl() noexcept
+  {
+    Logger::EchoDebug("", __func__);
+  }
+
+  DescriptorSetCache_impl::DescriptorSetCache_impl(std::shared_ptr<Device> dev, const DescriptorSetCacheConfig &params) :
+    allocator(dev, params.allocator_config)
+  {
+    if (dev.get() == nullptr || !dev->IsValid())
+    {
+      Logger::EchoError("Device is empty", __func__);
+      return;
+    }
+
+    device = dev;
+    config = params;
+  }
+
+  std::string DescriptorSetCache_impl::MakeKey(const VkDescriptorSetLayout layout, const LayoutConfig &info)
+  {
+    std::string result;
+    result.reserve(sizeof(layout) + info.info.size() * 80);
+    auto append = [&result] (const auto &value) { result.append((const char *) &value, sizeof(value)); };
+
+    append(layout);
+    for (size_t i = 0; i < info.info.size(); ++i)
+    {
+      auto &d = info.info[i];
+      append(d.type);
+      append(d.binding.value_or((uint32_t) i));
+      append(d.array_element);
+      append(d.buffer_info.buffer);
+      append(d.buffer_info.buffer_view);
+      append(d.offset);
+      append(d.size);
+      append(d.image_info.image_view);
+      append(d.image_info.sampler);
+      append(d.image_info.image_layout);
+    }
+
+    return result;
+  }
+
+  void DescriptorSetCache_impl::Evict()
+  {
+    while (entries.size() >= config.capacity && !lru.empty())
+    {
+      auto &oldest = lru.back();
+      if (oldest.last_frame + config.frames_in_flight > frame)
+      {
+        if (!overflow_reported)
+          Logger::EchoWarning("Capacity is exceeded by sets of in-flight frames", __func__);
+        overflow_reported = true;
+        return;
+      }
+
+      free_sets[oldest.layout].push_back(oldest.set);
+      entries.erase(oldest.key);
+      lru.pop_back();
+    }
+  }
+
+  VkResult DescriptorSetCache_impl::GetDescriptorSet(const VkDescriptorSetLayout layout, const LayoutConfig &info, VkDescriptorSet &set)
+  {
+    if (layout == VK_NULL_HANDLE || info.info.empty())
+    {
+      Logger::EchoError("Nothing to cache", __func__);
+      return VK_ERROR_UNKNOWN;
+    }
+
+    auto key = MakeKey(layout, info);
+    std::lock_guard lock(cache_mutex);
+
+    if (auto it = entries.find(key); it != entries.end())
+    {
+      lru.splice(lru.begin(), lru, it->second);
+      it->second->last_frame = frame;
+      set = it->second->set;
+      ++hits;
+      return VK_SUCCESS;
+    }
+
+    ++misses;
+    Evict();
+
+    VkDescriptorSet result = VK_NULL_HANDLE;
+    if (auto f = free_sets.find(layout); f != free_sets.end() && !f->second.empty())
+    {
+      result = f->second.back();
+      f->second.pop_back();
+    }
+    else if (auto er = allocator.Allocate(layout, result); er != VK_SUCCESS)
+    {
+      return er;
+    }
+
+    if (auto er = Descriptors_impl::WriteDescriptorSet(device->GetDevice(), result, info); er != VK_SUCCESS)
+    {
+      free_sets[layout].push_back(result);
+      return er;
+    }
+
+    lru.push_front({key, layout, result, frame});
+    entries[std::move(key)] = lru.begin();
+    set = result;
+
+    return VK_SUCCESS;
+  }
+
+  void DescriptorSetCache_impl::BeginFrame()
+  {
+    std::lock_guard lock(cache_mutex);
+    ++frame;
+    overflow_reported = false;
+
+    auto in_flight = [this] (const Entry &e) { return e.last_frame + config.frames_in_flight > frame; };
+    auto it = std::stable_partition(retired.begin(), retired.end(), in_flight);
+    for (auto e = it; e != retired.end(); ++e)
+      free_sets[e->layout].push_back(e->set);
+    retired.erase(it, retired.end());
+  }
+
+  void DescriptorSetCache_impl::Clear()
+  {
+    std::lock_guard lock(cache_mutex);
+    for (auto &e : lru)
+    {
+      if (e.last_frame + config.frames_in_flight > frame)
+        retired.push_back(std::move(e));
+      else
+        free_sets[e.layout].push_back(e.set);
+    }
+
+    lru.clear();
+    entries.clear();
+  }
+
+  size_t DescriptorSetCache_impl::GetSize()
+  {
+    std::lock_guard lock(cache_mutex);
+    return entries.size();
+  }
+
+  size_t DescriptorSetCache_impl::GetHitsCount()
+  {
+    std::lock_guard lock(cache_mutex);
+    return hits;
+  }
+
+  size_t DescriptorSetCache_impl::GetMissesCount()
+  {
+    std::lock_guard lock(cache_mutex);
+    return misses;
+  }
+
+  DescriptorSetCache &DescriptorSetCache::operator=(DescriptorSetCache &&obj) noexcept
+  {
+    if (&obj == this) return *this;
+
+    impl = std::move(obj.impl);
+    return *this;
+  }
+
+  void DescriptorSetCache::swap(DescriptorSetCache &obj) noexcept
+  {
+    if (&obj == this) return;
+
+    impl.swap(obj.impl);
+  }
+
+  void swap(DescriptorSetCache &lhs, DescriptorSetCache &rhs) noexcept
+  {
+    if (&lhs == &rhs) return;
+
+    lhs.swap(rhs);
+  }
+}
\ No newline at end of file
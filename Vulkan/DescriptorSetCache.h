@@ -0,0 +1,110 @@
+#ifndef __VULKAN_DESCRIPTOR_SET_CACHE_H
+#define __VULKAN_DESCRIPTOR_SET_CACHE_H
+
+#include "Logger.h"
+#include "Device.h"
+#include "Descriptors.h"
+#include "DescriptorAllocator.h"
+
+#include <vulkan/vulkan.h>
+#include <memory>
+#include <vector>
+#include <list>
+#include <map>
+#include <unordered_map>
+#include <string>
+#include <mutex>
+#include <algorithm>
+
+namespace Vulkan
+{
+  class DescriptorSetCacheConfig
+  {
+  private:
+    friend class DescriptorSetCache_impl;
+    size_t capacity = 1024;
+    size_t frames_in_flight = 2;
+    DescriptorAllocatorConfig allocator_config;
+  public:
+    DescriptorSetCacheConfig() = default;
+    ~DescriptorSetCacheConfig() noexcept = default;
+    auto &SetCapacity(const size_t count) { if (count > 0) capacity = count; return *this; }
+    auto &SetFramesInFlight(const size_t count) { frames_in_flight = count; return *this; }
+    auto &SetAllocatorConfig(const DescriptorAllocatorConfig &config) { allocator_config = config; allocator_config.SetFramesCount(1); return *this; }
+  };
+
+  class DescriptorSetCache_impl
+  {
+  public:
+    DescriptorSetCache_impl() = delete;
+    DescriptorSetCache_impl(const DescriptorSetCache_impl &obj) = delete;
+    DescriptorSetCache_impl(DescriptorSetCache_impl &&obj) = delete;
+    DescriptorSetCache_impl &operator=(const DescriptorSetCache_impl &obj) = delete;
+    DescriptorSetCache_impl &operator=(DescriptorSetCache_impl &&obj) = delete;
+    ~DescriptorSetCache_impl() noexcept;
+  private:
+    friend class DescriptorSetCache;
+    struct Entry
+    {
+      std::string key;
+      VkDescriptorSetLayout layout = VK_NULL_HANDLE;
+      VkDescriptorSet set = VK_NULL_HANDLE;
+      uint64_t last_frame = 0;
+    };
+
+    std::shared_ptr<Device> device;
+    DescriptorSetCacheConfig config;
+    DescriptorAllocator allocator;
+    std::list<Entry> lru;
+    std::unordered_map<std::string, std::list<Entry>::iterator> entries;
+    std::map<VkDescriptorSetLayout, std::vector<VkDescriptorSet>> free_sets;
+    std::vector<Entry> retired;
+    uint64_t frame = 0;
+    size_t hits = 0;
+    size_t misses = 0;
+    bool overflow_reported = false;
+    std::mutex cache_mutex;
+
+    DescriptorSetCache_impl(std::shared_ptr<Device> dev, const DescriptorSetCacheConfig &params);
+    static std::string MakeKey(const VkDescriptorSetLayout layout, const LayoutConfig &info);
+    void Evict();
+    VkResult GetDescriptorSet(const VkDescriptorSetLayout layout, const LayoutConfig &info, VkDescriptorSet &set);
+    void BeginFrame();
+    void Clear();
+    size_t GetSize();
+    size_t GetHitsCount();
+    size_t GetMissesCount();
+    std::shared_ptr<Device> GetDevice() const noexcept { return device; }
+  };
+
+  class DescriptorSetCache
+  {
+  private:
+    std::unique_ptr<DescriptorSetCache_impl> impl;
+  public:
+    DescriptorSetCache() = delete;
+    DescriptorSetCache(const DescriptorSetCache &obj) = delete;
+    DescriptorSetCache(DescriptorSetCache &&obj) noexcept : impl(std::move(obj.impl)) {};
+    DescriptorSetCache(std::shared_ptr<Device> dev, const DescriptorSetCacheConfig &params = {}) :
+      impl(std::unique_ptr<DescriptorSetCache_impl>(new DescriptorSetCache_impl(dev, params))) {};
+    DescriptorSetCache &operator=(const DescriptorSetCache &obj) = delete;
+    DescriptorSetCache &operator=(DescriptorSetCache &&obj) noexcept;
+    ~DescriptorSetCache() noexcept = default;
+    void swap(DescriptorSetCache &obj) noexcept;
+    bool IsValid() const noexcept { return impl.get() && impl->allocator.IsValid(); }
+
+    VkResult GetDescriptorSet(const VkDescriptorSetLayout layout, const LayoutConfig &info, VkDescriptorSet &set) { if (IsValid()) return impl->GetDescriptorSet(layout, info, set); return VK_ERROR_UNKNOWN; }
+    // Sets used in the last frames_in_flight frames are not evicted, so the cache may exceed its capacity until then
+    void BeginFrame() { if (IsValid()) impl->BeginFrame(); }
+    // Sets of in-flight frames are kept out of reuse until they are frames_in_flight frames old
+    void Clear() { if (IsValid()) impl->Clear(); }
+    size_t GetSize() { if (impl.get()) return impl->GetSize(); return 0; }
+    size_t GetHitsCount() { if (impl.get()) return impl->GetHitsCount(); return 0; }
+    size_t GetMissesCount() { if (impl.get()) return impl->GetMissesCount(); return 0; }
+    std::shared_ptr<Device> GetDevice() const noexcept { if (impl.get()) return impl->GetDevice(); return nullptr; }
+  };
+
+  void swap(DescriptorSetCache &lhs, DescriptorSetCache &rhs) noexcept;
+}
+
+#endif
\ No newline at end of file
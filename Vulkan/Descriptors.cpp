@@ -9,19 +9,30 @@ namespace Vulkan
     Destroy();
   }
 
-  void Descriptors_impl::Destroy() noexcept
+  void Descriptors_impl::ReleaseLayouts(std::vector<DescriptorSetLayout> &set_layouts) noexcept
   {
-    if (device != nullptr && device->GetDevice() != VK_NULL_HANDLE)
+    for (auto &layout : set_layouts)
     {
-      for (auto &layout : layouts)
+      if (layout.update_template != VK_NULL_HANDLE)
       {
-        if (layout.layout != VK_NULL_HANDLE)
-        {
-          vkDestroyDescriptorSetLayout(device->GetDevice(), layout.layout, nullptr);
-          layout.layout = VK_NULL_HANDLE;
-        }
+        vkDestroyDescriptorUpdateTemplate(device->GetDevice(), layout.update_template, nullptr);
+        layout.update_template = VK_NULL_HANDLE;
       }
-      layouts.clear();
+
+      if (layout.layout != VK_NULL_HANDLE)
+      {
+        device->ReleaseDescriptorSetLayout(layout.layout);
+        layout.layout = VK_NULL_HANDLE;
+      }
+    }
+    set_layouts.clear();
+  }
+
+  void Descriptors_impl::Destroy() noexcept
+  {
+    if (device != nullptr && device->GetDevice() != VK_NULL_HANDLE)
+    {
+      ReleaseLayouts(layouts);
 
       if (descriptor_pool != VK_NULL_HANDLE)
       {
@@ -44,16 +55,17 @@ namespace Vulkan
     device = dev;
   }
 
-  DescriptorType DescriptorInfo::MapStorageType(StorageType type) noexcept
+  DescriptorType DescriptorInfo::MapStorageType(StorageType type, const bool dynamic) noexcept
   {
     switch (type)
     {
       case StorageType::Storage:
       case StorageType::Index:
       case StorageType::Vertex:
-        return DescriptorType::BufferStorage;
+      case StorageType::Indirect:
+        return dynamic ? DescriptorType::BufferStorageDynamic : DescriptorType::BufferStorage;
       case StorageType::Uniform:
-        return DescriptorType::BufferUniform;
+        return dynamic ? DescriptorType::BufferUniformDynamic : DescriptorType::BufferUniform;
       case StorageType::TexelStorage:
         return DescriptorType::TexelStorage;
       case StorageType::TexelUniform:
@@ -74,6 +86,7 @@ namespace Vulkan
 
     VkDescriptorPoolCreateInfo descriptor_pool_create_info = {};
     descriptor_pool_create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    descriptor_pool_create_info.flags = update_after_bind ? VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT : 0;
     descriptor_pool_create_info.maxSets = pool_conf.max_sets;
     descriptor_pool_create_info.pPoolSizes = pool_conf.sizes.data();
     descriptor_pool_create_info.poolSizeCount = (uint32_t) pool_conf.sizes.size();
@@ -89,35 +102,121 @@ namespace Vulkan
     return result;
   }
 
+  std::vector<VkDescriptorSetLayoutBinding> Descriptors_impl::GetLayoutBindings(const LayoutConfig &info) const
+  {
+    std::vector<VkDescriptorSetLayoutBinding> result;
+    result.reserve(info.info.size());
+
+    for (size_t i = 0; i < info.info.size(); ++i)
+    {
+      uint32_t binding = info.info[i].binding.value_or((uint32_t) i);
+      auto it = std::find_if(result.begin(), result.end(), [binding] (const auto &b) { return b.binding == binding; });
+      if (it == result.end())
+      {
+        VkDescriptorSetLayoutBinding descriptor_set_layout_binding = {};
+        descriptor_set_layout_binding.binding = binding;
+        descriptor_set_layout_binding.descriptorType = (VkDescriptorType)info.info[i].type;
+        descriptor_set_layout_binding.stageFlags = info.info[i].stage;
+        descriptor_set_layout_binding.pImmutableSamplers = nullptr;
+        descriptor_set_layout_binding.descriptorCount = info.info[i].array_element + 1;
+        result.push_back(descriptor_set_layout_binding);
+        continue;
+      }
+
+      if (it->descriptorType != (VkDescriptorType)info.info[i].type)
+      {
+        Logger::EchoError("Different descriptor types in binding " + std::to_string(binding), __func__);
+        return {};
+      }
+
+      it->stageFlags |= info.info[i].stage;
+      it->descriptorCount = std::max(it->descriptorCount, info.info[i].array_element + 1);
+    }
+
+    return result;
+  }
+
+  VkDescriptorBindingFlags Descriptors_impl::GetBindingFlags(const VkDescriptorType type) const noexcept
+  {
+    if (!update_after_bind)
+      return 0;
+
+    auto f = device->GetEnabledVulkan12Features();
+    VkBool32 supported = VK_FALSE;
+    switch (type)
+    {
+      case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+        supported = f.descriptorBindingStorageBufferUpdateAfterBind;
+        break;
+      case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+        supported = f.descriptorBindingUniformBufferUpdateAfterBind;
+        break;
+      case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
+        supported = f.descriptorBindingStorageTexelBufferUpdateAfterBind;
+        break;
+      case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
+        supported = f.descriptorBindingUniformTexelBufferUpdateAfterBind;
+        break;
+      case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+        supported = f.descriptorBindingStorageImageUpdateAfterBind;
+        break;
+      case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+      case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+      case VK_DESCRIPTOR_TYPE_SAMPLER:
+        supported = f.descriptorBindingSampledImageUpdateAfterBind;
+        break;
+      default:
+        break;
+    }
+
+    VkDescriptorBindingFlags result = f.descriptorBindingUpdateUnusedWhilePending ? VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT : 0;
+    if (supported)
+      result |= VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT;
+
+    return result;
+  }
+
   DescriptorSetLayout Descriptors_impl::CreateDescriptorSetLayout(const LayoutConfig &info)
   {
     DescriptorSetLayout result = {};
     VkDescriptorSetLayoutCreateInfo descriptor_set_layout_create_info = {};
-    std::vector<VkDescriptorSetLayoutBinding> descriptor_set_layout_bindings;
-    descriptor_set_layout_bindings.reserve(info.info.size());
-
-    for (size_t i = 0; i < info.info.size(); ++i)
+    auto descriptor_set_layout_bindings = GetLayoutBindings(info);
+    if (descriptor_set_layout_bindings.empty())
     {
-      VkDescriptorSetLayoutBinding descriptor_set_layout_binding = {};
-      descriptor_set_layout_binding.binding = i;
-      descriptor_set_layout_binding.descriptorType = (VkDescriptorType)info.info[i].type;
-      descriptor_set_layout_binding.stageFlags = info.info[i].stage;
-      descriptor_set_layout_binding.pImmutableSamplers = nullptr;
-      descriptor_set_layout_binding.descriptorCount = 1;
-      descriptor_set_layout_bindings.push_back(descriptor_set_layout_binding);
+      Logger::EchoError("No bindings", __func__);
+      return result;
     }
 
     descriptor_set_layout_create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
     descriptor_set_layout_create_info.bindingCount = (uint32_t)descriptor_set_layout_bindings.size();
     descriptor_set_layout_create_info.pBindings = descriptor_set_layout_bindings.data();
 
-    auto er = vkCreateDescriptorSetLayout(device->GetDevice(), &descriptor_set_layout_create_info, nullptr, &result.layout);
-    if (er != VK_SUCCESS)
+    std::vector<VkDescriptorBindingFlags> binding_flags(descriptor_set_layout_bindings.size());
+    for (size_t i = 0; i < binding_flags.size(); ++i)
+      binding_flags[i] = GetBindingFlags(descriptor_set_layout_bindings[i].descriptorType);
+
+    auto is_dynamic = [] (const auto &b) { return b.descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC || b.descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC; };
+    if (update_after_bind && std::any_of(descriptor_set_layout_bindings.begin(), descriptor_set_layout_bindings.end(), is_dynamic))
     {
-      Logger::EchoError("Can't create DescriptorSetLayout.", __func__);
-      Logger::EchoDebug("Return code = " + std::to_string(er), __func__);
+      Logger::EchoWarning("Set with dynamic buffers can't be updated after bind", __func__);
+      for (auto &f : binding_flags)
+        f &= ~VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT;
     }
 
+    VkDescriptorSetLayoutBindingFlagsCreateInfo binding_flags_info = {};
+    binding_flags_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+    binding_flags_info.bindingCount = (uint32_t) binding_flags.size();
+    binding_flags_info.pBindingFlags = binding_flags.data();
+
+    if (std::any_of(binding_flags.begin(), binding_flags.end(), [] (auto f) { return f != 0; }))
+      descriptor_set_layout_create_info.pNext = &binding_flags_info;
+    if (std::any_of(binding_flags.begin(), binding_flags.end(), [] (auto f) { return (f & VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT) != 0; }))
+      descriptor_set_layout_create_info.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+
+    result.layout = device->AcquireDescriptorSetLayout(descriptor_set_layout_create_info);
+    if (result.layout == VK_NULL_HANDLE)
+      Logger::EchoError("Can't create DescriptorSetLayout.", __func__);
+
     return result;
   }
 
@@ -141,6 +240,96 @@ namespace Vulkan
   }
 
   VkResult Descriptors_impl::UpdateDescriptorSet(const DescriptorSetLayout& layout, const LayoutConfig& info)
+  {
+    if (layout.update_template == VK_NULL_HANDLE)
+      return WriteDescriptorSet(device->GetDevice(), layout.set, info);
+
+    auto data = PackDescriptorData(info);
+    vkUpdateDescriptorSetWithTemplate(device->GetDevice(), layout.set, layout.update_template, data.data());
+
+    return VK_SUCCESS;
+  }
+
+  VkDescriptorUpdateTemplate Descriptors_impl::CreateUpdateTemplate(const VkDescriptorSetLayout layout, const LayoutConfig &info)
+  {
+    std::vector<VkDescriptorUpdateTemplateEntry> entries(info.info.size());
+    for (size_t i = 0; i < info.info.size(); ++i)
+    {
+      entries[i].dstBinding = info.info[i].binding.value_or((uint32_t) i);
+      entries[i].dstArrayElement = info.info[i].array_element;
+      entries[i].descriptorCount = 1;
+      entries[i].descriptorType = (VkDescriptorType) info.info[i].type;
+      entries[i].offset = i * sizeof(DescriptorData);
+      entries[i].stride = sizeof(DescriptorData);
+    }
+
+    VkDescriptorUpdateTemplateCreateInfo template_create_info = {};
+    template_create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO;
+    template_create_info.descriptorUpdateEntryCount = (uint32_t) entries.size();
+    template_create_info.pDescriptorUpdateEntries = entries.data();
+    template_create_info.templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET;
+    template_create_info.descriptorSetLayout = layout;
+
+    VkDescriptorUpdateTemplate result = VK_NULL_HANDLE;
+    if (auto er = vkCreateDescriptorUpdateTemplate(device->GetDevice(), &template_create_info, nullptr, &result); er != VK_SUCCESS)
+    {
+      Logger::EchoWarning("Can't create descriptor update template", __func__);
+      Logger::EchoDebug("Return code = " + std::to_string(er), __func__);
+      return VK_NULL_HANDLE;
+    }
+
+    return result;
+  }
+
+  std::vector<Descriptors_impl::DescriptorData> Descriptors_impl::PackDescriptorData(const LayoutConfig &info)
+  {
+    std::vector<DescriptorData> result(info.info.size());
+    for (size_t i = 0; i < info.info.size(); ++i)
+    {
+      auto &d = info.info[i];
+      switch (d.type)
+      {
+      case DescriptorType::BufferStorage:
+      case DescriptorType::BufferUniform:
+      case DescriptorType::BufferStorageDynamic:
+      case DescriptorType::BufferUniformDynamic:
+        result[i].buffer = { d.buffer_info.buffer, d.offset, d.size };
+        break;
+      case DescriptorType::TexelUniform:
+      case DescriptorType::TexelStorage:
+        result[i].texel_view = d.buffer_info.buffer_view;
+        break;
+      case DescriptorType::ImageSamplerCombined:
+      case DescriptorType::Sampler:
+        result[i].image = { d.image_info.sampler, d.image_info.image_view, d.image_info.image_layout };
+        break;
+      case DescriptorType::ImageSampled:
+      case DescriptorType::ImageStorage:
+        result[i].image = { VK_NULL_HANDLE, d.image_info.image_view, d.image_info.image_layout };
+        break;
+      }
+    }
+
+    return result;
+  }
+
+  bool Descriptors_impl::IsSameShape(const LayoutConfig &lhs, const LayoutConfig &rhs) noexcept
+  {
+    if (lhs.info.size() != rhs.info.size())
+      return false;
+
+    for (size_t i = 0; i < lhs.info.size(); ++i)
+    {
+      if (lhs.info[i].type != rhs.info[i].type ||
+          lhs.info[i].binding.value_or((uint32_t) i) != rhs.info[i].binding.value_or((uint32_t) i) ||
+          lhs.info[i].array_element != rhs.info[i].array_element)
+        return false;
+    }
+
+    return true;
+  }
+
+  VkResult Descriptors_impl::WriteDescriptorSet(const VkDevice device, const VkDescriptorSet set, const LayoutConfig& info)
   {
     std::vector<VkWriteDescriptorSet> descriptor_writes(info.info.size());
     std::pair<uint32_t, uint32_t> count = std::make_pair(0, 0);
@@ -150,6 +339,8 @@ namespace Vulkan
       {
       case DescriptorType::BufferStorage:
       case DescriptorType::BufferUniform:
+      case DescriptorType::BufferStorageDynamic:
+      case DescriptorType::BufferUniformDynamic:
       case DescriptorType::TexelUniform:
       case DescriptorType::TexelStorage:
         count.first++;
@@ -173,9 +364,9 @@ namespace Vulkan
     for (size_t i = 0; i < info.info.size(); ++i)
     {
       descriptor_writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-      descriptor_writes[i].dstSet = layout.set;
-      descriptor_writes[i].dstBinding = i;
-      descriptor_writes[i].dstArrayElement = 0;
+      descriptor_writes[i].dstSet = set;
+      descriptor_writes[i].dstBinding = info.info[i].binding.value_or((uint32_t) i);
+      descriptor_writes[i].dstArrayElement = info.info[i].array_element;
       descriptor_writes[i].descriptorCount = 1;
       descriptor_writes[i].descriptorType = (VkDescriptorType)info.info[i].type;
 
@@ -183,6 +374,8 @@ namespace Vulkan
       {
       case DescriptorType::BufferStorage:
       case DescriptorType::BufferUniform:
+      case DescriptorType::BufferStorageDynamic:
+      case DescriptorType::BufferUniformDynamic:
       case DescriptorType::TexelUniform:
       case DescriptorType::TexelStorage:
         buffer_infos[count.first].buffer = info.info[i].buffer_info.buffer;
@@ -219,7 +412,7 @@ namespace Vulkan
       }
     }
 
-    vkUpdateDescriptorSets(device->GetDevice(), (uint32_t)descriptor_writes.size(), descriptor_writes.data(), 0, nullptr);
+    vkUpdateDescriptorSets(device, (uint32_t)descriptor_writes.size(), descriptor_writes.data(), 0, nullptr);
   
     return VK_SUCCESS;
   }
@@ -237,15 +430,63 @@ namespace Vulkan
     return VK_SUCCESS;
   }
 
+  VkResult Descriptors_impl::AddSetLayoutConfig(const LayoutConfig &config, const ShaderReflection &reflection, const uint32_t set)
+  {
+    if (!reflection.IsValid())
+    {
+      Logger::EchoError("Reflection is not valid", __func__);
+      return VK_ERROR_UNKNOWN;
+    }
+
+    auto bindings = reflection.GetBindings(set);
+    LayoutConfig result = config;
+    size_t index = 0;
+
+    for (auto &b : bindings)
+    {
+      size_t count = b.count > 0 ? b.count : result.info.size() - std::min(index, result.info.size());
+      if (index + count > result.info.size())
+      {
+        Logger::EchoError("Not enough descriptors for set " + std::to_string(set), __func__);
+        return VK_ERROR_UNKNOWN;
+      }
+
+      for (size_t i = 0; i < count; ++i, ++index)
+      {
+        auto &info = result.info[index];
+        auto type = (VkDescriptorType) info.type;
+        if (type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC) type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        if (type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC) type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        if (type != b.type)
+        {
+          Logger::EchoError("Descriptor type mismatch in binding " + std::to_string(b.binding), __func__);
+          return VK_ERROR_UNKNOWN;
+        }
+
+        info.binding = b.binding;
+        info.array_element = (uint32_t) i;
+        info.stage = b.stage;
+      }
+    }
+
+    if (index != result.info.size())
+    {
+      Logger::EchoError("Too many descriptors for set " + std::to_string(set), __func__);
+      return VK_ERROR_UNKNOWN;
+    }
+
+    return AddSetLayoutConfig(result);
+  }
+
   VkResult Descriptors_impl::BuildAllSetLayoutConfigs()
   {
     PoolConfig conf;
 
     for (auto &b : build_config)
     {
-      for (auto &c : b.info)
+      for (auto &c : GetLayoutBindings(b))
       {
-        conf.AddDescriptorType(c.type);
+        conf.AddDescriptorType(c.descriptorType, c.descriptorCount);
       }
     }
 
@@ -266,24 +507,39 @@ namespace Vulkan
 
     std::vector<DescriptorSetLayout> tmp_layouts;
     tmp_layouts.reserve(build_config.size());
+    auto release = [this, &tmp_layouts, tmp_desc_pool] ()
+    {
+      ReleaseLayouts(tmp_layouts);
+      vkDestroyDescriptorPool(device->GetDevice(), tmp_desc_pool, nullptr);
+    };
+
     for (auto& b : build_config)
     {
       auto layout = CreateDescriptorSetLayout(b);
-      auto er = CreateDescriptorSets(tmp_desc_pool, layout);
+      if (layout.layout == VK_NULL_HANDLE)
+      {
+        Logger::EchoError("Can't create DescriptorSetLayout", __func__);
+        release();
+        return VK_ERROR_UNKNOWN;
+      }
+
+      layout.update_template = CreateUpdateTemplate(layout.layout, b);
+      tmp_layouts.push_back(layout);
+      auto er = CreateDescriptorSets(tmp_desc_pool, tmp_layouts.back());
       if (er != VK_SUCCESS)
       {
         Logger::EchoError("Can't create CreateDescriptorSets", __func__);
+        release();
         return er;
       }
 
-      er = UpdateDescriptorSet(layout, b);
+      er = UpdateDescriptorSet(tmp_layouts.back(), b);
       if (er != VK_SUCCESS)
       {
         Logger::EchoError("Can't update CreateDescriptorSets", __func__);
+        release();
         return er;
       }
-
-      tmp_layouts.push_back(layout);
     }
 
     Destroy();
@@ -300,6 +556,67 @@ namespace Vulkan
     build_config.clear();
   }
 
+  VkResult Descriptors_impl::UpdateDescriptorSet(const size_t index, const LayoutConfig &config)
+  {
+    if (index >= layouts.size() || index >= build_config_copy.size())
+    {
+      Logger::EchoError("Index is out off range", __func__);
+      return VK_ERROR_UNKNOWN;
+    }
+
+    if (!IsSameShape(build_config_copy[index], config))
+    {
+      Logger::EchoError("Config doesn't match the set layout", __func__);
+      return VK_ERROR_UNKNOWN;
+    }
+
+    if (auto er = UpdateDescriptorSet(layouts[index], config); er != VK_SUCCESS)
+      return er;
+
+    build_config_copy[index] = config;
+    return VK_SUCCESS;
+  }
+
+  VkResult Descriptors_impl::UpdateBinding(const size_t index, const uint32_t binding, const DescriptorInfo &info)
+  {
+    if (index >= layouts.size() || index >= build_config_copy.size())
+    {
+      Logger::EchoError("Index is out off range", __func__);
+      return VK_ERROR_UNKNOWN;
+    }
+
+    auto &config = build_config_copy[index].info;
+    size_t i = 0;
+    for (; i < config.size(); ++i)
+    {
+      if (config[i].binding.value_or((uint32_t) i) == binding && config[i].array_element == info.array_element)
+        break;
+    }
+
+    if (i == config.size())
+    {
+      Logger::EchoError("No binding " + std::to_string(binding) + " in set " + std::to_string(index), __func__);
+      return VK_ERROR_UNKNOWN;
+    }
+
+    if (config[i].type != info.type)
+    {
+      Logger::EchoError("Descriptor type mismatch in binding " + std::to_string(binding), __func__);
+      return VK_ERROR_UNKNOWN;
+    }
+
+    LayoutConfig single;
+    single.info.push_back(info);
+    single.info.back().binding = binding;
+    single.info.back().stage = config[i].stage;
+
+    if (auto er = WriteDescriptorSet(device->GetDevice(), layouts[index].set, single); er != VK_SUCCESS)
+      return er;
+
+    config[i] = single.info.back();
+    return VK_SUCCESS;
+  }
+
   std::vector<VkDescriptorSetLayout> Descriptors_impl::GetDescriptorSetLayouts() const
   {
     std::vector<VkDescriptorSetLayout> result(layouts.size());
@@ -334,6 +651,7 @@ namespace Vulkan
 
     back.swap(impl->build_config);
     impl->build_config = obj.impl->build_config_copy;
+    impl->update_after_bind = obj.impl->update_after_bind;
 
     if (auto er = impl->BuildAllSetLayoutConfigs(); er != VK_SUCCESS)
     {
@@ -353,6 +671,7 @@ namespace Vulkan
     }
 
     impl = std::unique_ptr<Descriptors_impl>(new Descriptors_impl(obj.impl->device));
+    impl->update_after_bind = obj.impl->update_after_bind;
 
     if (obj.impl->layouts.empty() || obj.impl->build_config_copy.empty())
       return;
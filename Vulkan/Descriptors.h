@@ -4,12 +4,14 @@
 #include "Logger.h"
 #include "Device.h"
 #include "StorageArray.h"
+#include "Pipelines/ShaderReflection.h"
 
 #include <vulkan/vulkan.h>
 #include <memory>
 #include <vector>
 #include <mutex>
 #include <iostream>
+#include <optional>
 
 namespace Vulkan
 {
@@ -17,6 +19,8 @@ namespace Vulkan
   {
     BufferStorage = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
     BufferUniform = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+    BufferStorageDynamic = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC,
+    BufferUniformDynamic = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
     TexelStorage = VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER,
     TexelUniform = VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER,
     ImageSamplerCombined = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
@@ -29,6 +33,7 @@ namespace Vulkan
   {
     VkDescriptorSetLayout layout = VK_NULL_HANDLE;
     VkDescriptorSet set = VK_NULL_HANDLE;
+    VkDescriptorUpdateTemplate update_template = VK_NULL_HANDLE;
   };
 
   struct DescriptorInfo
@@ -50,13 +55,17 @@ namespace Vulkan
     VkDeviceSize offset = 0;
     VkShaderStageFlags stage = VK_SHADER_STAGE_ALL;
     DescriptorType type;
-    static DescriptorType MapStorageType(StorageType type) noexcept;
+    std::optional<uint32_t> binding;
+    uint32_t array_element = 0;
+    static DescriptorType MapStorageType(StorageType type, const bool dynamic = false) noexcept;
   };
 
   class LayoutConfig
   {
   private:
     friend class Descriptors_impl;
+    friend class DescriptorAllocator_impl;
+    friend class DescriptorSetCache_impl;
     std::vector<DescriptorInfo> info;
   public:
     LayoutConfig() = default;
@@ -104,6 +113,8 @@ namespace Vulkan
         }
       case DescriptorType::BufferStorage:
       case DescriptorType::BufferUniform:
+      case DescriptorType::BufferStorageDynamic:
+      case DescriptorType::BufferUniformDynamic:
       case DescriptorType::TexelUniform:
       case DescriptorType::TexelStorage:
         if (desc_info.buffer_info.buffer != VK_NULL_HANDLE)
@@ -130,39 +141,60 @@ namespace Vulkan
     ~Descriptors_impl() noexcept;
   private:
     friend class Descriptors;
+    friend class DescriptorAllocator_impl;
+    friend class DescriptorSetCache_impl;
     VkDescriptorPool descriptor_pool = VK_NULL_HANDLE;
     std::shared_ptr<Device> device;
     std::vector<LayoutConfig> build_config;
     std::vector<LayoutConfig> build_config_copy;
     std::vector<DescriptorSetLayout> layouts;
+    bool update_after_bind = false;
     struct PoolConfig
     {
       std::vector<VkDescriptorPoolSize> sizes;
       uint32_t max_sets = 0;
-      void AddDescriptorType(const DescriptorType type) noexcept
+      void AddDescriptorType(const VkDescriptorType type, const uint32_t count = 1) noexcept
       {
         for (auto &d : sizes)
         {
-          if (d.type == (VkDescriptorType) type)
+          if (d.type == type)
           {
-            d.descriptorCount++;
+            d.descriptorCount += count;
             return;
           }
         }
-        try { sizes.push_back({(VkDescriptorType) type, 1}); } catch (...) {}
+        try { sizes.push_back({type, count}); } catch (...) {}
       }
     };
     
+    union DescriptorData
+    {
+      VkDescriptorBufferInfo buffer;
+      VkDescriptorImageInfo image;
+      VkBufferView texel_view;
+    };
+    
     Descriptors_impl(std::shared_ptr<Device> dev);
     VkDescriptorPool CreateDescriptorPool(const PoolConfig &pool_conf);
+    std::vector<VkDescriptorSetLayoutBinding> GetLayoutBindings(const LayoutConfig &info) const;
+    VkDescriptorBindingFlags GetBindingFlags(const VkDescriptorType type) const noexcept;
     DescriptorSetLayout CreateDescriptorSetLayout(const LayoutConfig &info);
     VkResult CreateDescriptorSets(const VkDescriptorPool pool, DescriptorSetLayout &layout);
     VkResult UpdateDescriptorSet(const DescriptorSetLayout &layout, const LayoutConfig &info);
+    static VkResult WriteDescriptorSet(const VkDevice device, const VkDescriptorSet set, const LayoutConfig &info);
+    VkDescriptorUpdateTemplate CreateUpdateTemplate(const VkDescriptorSetLayout layout, const LayoutConfig &info);
+    static std::vector<DescriptorData> PackDescriptorData(const LayoutConfig &info);
+    static bool IsSameShape(const LayoutConfig &lhs, const LayoutConfig &rhs) noexcept;
+    void ReleaseLayouts(std::vector<DescriptorSetLayout> &set_layouts) noexcept;
     void Destroy() noexcept;
 
     VkResult AddSetLayoutConfig(const LayoutConfig &config);
+    VkResult AddSetLayoutConfig(const LayoutConfig &config, const ShaderReflection &reflection, const uint32_t set);
     VkResult BuildAllSetLayoutConfigs();
     void ClearAllSetLayoutConfigs() noexcept;
+    VkResult UpdateDescriptorSet(const size_t index, const LayoutConfig &config);
+    VkResult UpdateBinding(const size_t index, const uint32_t binding, const DescriptorInfo &info);
+    void SetUpdateAfterBind(const bool enable) noexcept { update_after_bind = enable; }
     size_t GetLayoutsCount() const noexcept { return layouts.size(); }
     VkDescriptorSetLayout GetDescriptorSetLayout(const size_t index) const noexcept {  return index < layouts.size() ? layouts[index].layout : VK_NULL_HANDLE; }
     VkDescriptorSet GetDescriptorSet(const size_t index) const noexcept { return index < layouts.size() ? layouts[index].set : VK_NULL_HANDLE; }
@@ -185,8 +217,12 @@ namespace Vulkan
     void swap(Descriptors &obj) noexcept;
     ~Descriptors() noexcept = default;
     VkResult AddSetLayoutConfig(const LayoutConfig &config) { if (impl.get()) return impl->AddSetLayoutConfig(config); return VK_ERROR_UNKNOWN; }
+    VkResult AddSetLayoutConfig(const LayoutConfig &config, const ShaderReflection &reflection, const uint32_t set) { if (impl.get()) return impl->AddSetLayoutConfig(config, reflection, set); return VK_ERROR_UNKNOWN; }
     VkResult BuildAllSetLayoutConfigs() { if (impl.get()) return impl->BuildAllSetLayoutConfigs(); return VK_ERROR_UNKNOWN; }
     void ClearAllSetLayoutConfigs() { if (impl.get()) impl->ClearAllSetLayoutConfigs(); }
+    VkResult UpdateDescriptorSet(const size_t index, const LayoutConfig &config) { if (impl.get()) return impl->UpdateDescriptorSet(index, config); return VK_ERROR_UNKNOWN; }
+    VkResult UpdateBinding(const size_t index, const uint32_t binding, const DescriptorInfo &info) { if (impl.get()) return impl->UpdateBinding(index, binding, info); return VK_ERROR_UNKNOWN; }
+    void SetUpdateAfterBind(const bool enable) noexcept { if (impl.get()) impl->SetUpdateAfterBind(enable); }
     size_t GetLayoutsCount() const noexcept { if (impl.get()) return impl->GetLayoutsCount(); return 0; }
     VkDescriptorSetLayout GetDescriptorSetLayout(const size_t index) const noexcept { if (impl.get()) return impl->GetDescriptorSetLayout(index); return VK_NULL_HANDLE; }
     VkDescriptorSet GetDescriptorSet(const size_t index) const noexcept { if (impl.get()) return impl->GetDescriptorSet(index); return VK_NULL_HANDLE; }
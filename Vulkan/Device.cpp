@@ -7,6 +7,16 @@ namespace Vulkan
     Logger::EchoDebug("", __func__);
     if (device != VK_NULL_HANDLE)
     {
+      ClearSyncPools();
+      ClearShaderModules();
+      ClearDescriptorSetLayouts();
+      SaveAutotuneResults();
+      if (pipeline_cache != VK_NULL_HANDLE)
+      {
+        SavePipelineCache();
+        vkDestroyPipelineCache(device, pipeline_cache, nullptr);
+        pipeline_cache = VK_NULL_HANDLE;
+      }
       vkDestroyDevice(device, nullptr);
       device = VK_NULL_HANDLE;
     }
@@ -60,29 +70,41 @@ namespace Vulkan
     std::vector<VkQueueFamilyProperties> queue_families(family_queues_count);
     vkGetPhysicalDeviceQueueFamilyProperties(p_device.device, &family_queues_count, queue_families.data());
 
-    ret.resize(3);
+    ret.resize(5);
     ret[0].purpose = QueuePurpose::GraphicPurpose;
     ret[1].purpose = QueuePurpose::PresentationPurpose;
     ret[2].purpose = QueuePurpose::ComputePurpose;
+    ret[3].purpose = QueuePurpose::TransferPurpose;
+    ret[4].purpose = QueuePurpose::AsyncComputePurpose;
 
-    for (VkDeviceSize i = 0; i < family_queues_count; ++i)
+    auto set_family = [&queue_families] (Queue &q, const uint32_t index)
     {
-      if (queue_families[i].queueFlags & (VkQueueFlags)QueueType::ComputeType && !ret[2].family.has_value())
-      {
-        ret[2].family = i;
-        ret[2].props = queue_families[i];
-        ret[2].queue_priority = 1.0f;
-      }
+      q.family = index;
+      q.props = queue_families[index];
+      q.queue_priority = 1.0f;
+    };
+
+    // Every family has to be visited: dedicated transfer and async compute
+    // families usually follow the universal one.
+    for (uint32_t i = 0; i < family_queues_count; ++i)
+    {
+      VkQueueFlags flags = queue_families[i].queueFlags;
+
+      if (flags & (VkQueueFlags)QueueType::ComputeType && !ret[2].family.has_value())
+        set_family(ret[2], i);
+
+      if (queue_flag_bits != QueueType::DrawingType && (flags & (VkQueueFlags)QueueType::ComputeType) && 
+          !(flags & (VkQueueFlags)QueueType::DrawingType) && !ret[4].family.has_value())
+        set_family(ret[4], i);
+
+      if ((flags & VK_QUEUE_TRANSFER_BIT) && !(flags & (VkQueueFlags)QueueType::DrawingAndComputeType) && !ret[3].family.has_value())
+        set_family(ret[3], i);
 
-      if (queue_families[i].queueFlags & (VkQueueFlags)QueueType::DrawingType)
+      if (flags & (VkQueueFlags)QueueType::DrawingType)
       {
         VkBool32 present = false;
         if (!ret[0].family.has_value())
-        {
-          ret[0].family = i;
-          ret[0].props = queue_families[i];
-          ret[0].queue_priority = 1.0f;
-        }
+          set_family(ret[0], i);
 
         if (queue_flag_bits != QueueType::ComputeType && vkGetPhysicalDeviceSurfaceSupportKHR(p_device.device, i, surface->GetSurface(), &present) != VK_SUCCESS)
         {
@@ -92,31 +114,8 @@ namespace Vulkan
         }
 
         if (present && !ret[1].family.has_value())
-        {
-          ret[1].family = i;
-          ret[1].props = queue_families[i];
-          ret[1].queue_priority = 1.0f;
-        }
+          set_family(ret[1], i);
       }
-
-      bool done = true;
-      for (size_t j = 0; j < 3; ++j)
-      {
-        if (queue_flag_bits == QueueType::ComputeType)
-        {
-          if (j == 0 && j == 1)
-            continue;
-        }
-        if (queue_flag_bits == QueueType::DrawingType)
-        {
-          if (j == 2)
-            continue;
-        }
-        if (!ret[i].family.has_value())
-          done = false;
-      }
-      if (done)
-        break;
     }
 
     if (queue_flag_bits == QueueType::ComputeType)
@@ -138,10 +137,29 @@ namespace Vulkan
     return ret;
   }
 
+  VkPhysicalDeviceVulkan12Features Device_impl::GetSupportedVulkan12Features() const
+  {
+    VkPhysicalDeviceVulkan12Features ret = {};
+    ret.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+
+    if (Instance::GetApiVersion() < VK_API_VERSION_1_2 || p_device.device_properties.apiVersion < VK_API_VERSION_1_2)
+      return ret;
+
+    VkPhysicalDeviceFeatures2 features = {};
+    features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features.pNext = &ret;
+    vkGetPhysicalDeviceFeatures2(p_device.device, &features);
+    ret.pNext = nullptr;
+
+    return ret;
+  }
+
   Device_impl::Device_impl(const DeviceConfig params)
   {
     surface = params.surface;
     queue_flag_bits = params.queue_flags;
+    queues_per_family = std::max(params.queues_per_family, (uint32_t) 1);
+    pipeline_cache_dir = params.pipeline_cache_dir;
 
     auto devices = GetAllPhysicalDevices();
 
@@ -278,7 +296,207 @@ namespace Vulkan
       p_device = {};
       device = VK_NULL_HANDLE;
       Logger::EchoError("No suitable devices", __func__);
+      return;
+    }
+
+    CreatePipelineCache();
+    LoadAutotuneResults();
+  }
+
+  std::filesystem::path Device_impl::GetPipelineCachePath() const
+  {
+    if (pipeline_cache_dir.empty())
+      return {};
+
+    std::stringstream name;
+    name << "pipeline_cache_" << std::hex << p_device.device_properties.vendorID << "_" << p_device.device_properties.deviceID << "_";
+    for (auto b : p_device.device_properties.pipelineCacheUUID)
+      name << std::setw(2) << std::setfill('0') << (uint32_t) b;
+    name << ".bin";
+
+    return pipeline_cache_dir / name.str();
+  }
+
+  std::string Device_impl::GetDeviceUUID() const
+  {
+    VkPhysicalDeviceIDProperties id_props = {};
+    id_props.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES;
+    VkPhysicalDeviceProperties2 props = {};
+    props.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    props.pNext = &id_props;
+    vkGetPhysicalDeviceProperties2(p_device.device, &props);
+
+    std::stringstream uuid;
+    uuid << std::hex;
+    for (auto b : id_props.deviceUUID)
+      uuid << std::setw(2) << std::setfill('0') << (uint32_t) b;
+
+    return uuid.str();
+  }
+
+  std::filesystem::path Device_impl::GetAutotunePath() const
+  {
+    if (pipeline_cache_dir.empty())
+      return {};
+
+    return pipeline_cache_dir / ("autotune_" + GetDeviceUUID() + ".txt");
+  }
+
+  void Device_impl::LoadAutotuneResults()
+  {
+    auto path = GetAutotunePath();
+    if (path.empty() || !std::filesystem::exists(path))
+      return;
+
+    std::ifstream f(path);
+    std::string name;
+    WorkgroupSize size;
+
+    std::lock_guard<std::mutex> lock(tune_mutex);
+    while (f >> name >> size.x >> size.y >> size.z)
+      tuned_workgroups[name] = size;
+  }
+
+  VkResult Device_impl::SaveAutotuneResults()
+  {
+    auto path = GetAutotunePath();
+    std::lock_guard<std::mutex> lock(tune_mutex);
+    if (path.empty() || tuned_workgroups.empty())
+      return VK_SUCCESS;
+
+    try
+    {
+      std::filesystem::create_directories(pipeline_cache_dir);
+      auto tmp_path = path;
+      tmp_path += ".tmp";
+      {
+        std::ofstream f(tmp_path, std::ios::trunc);
+        if (!f.is_open())
+        {
+          Logger::EchoError("Can't open autotune file", __func__);
+          return VK_ERROR_INITIALIZATION_FAILED;
+        }
+        for (auto &t : tuned_workgroups)
+          f << t.first << " " << t.second.x << " " << t.second.y << " " << t.second.z << "\n";
+      }
+      std::filesystem::rename(tmp_path, path);
+    }
+    catch (...)
+    {
+      Logger::EchoError("Can't save autotune results", __func__);
+      return VK_ERROR_INITIALIZATION_FAILED;
     }
+
+    return VK_SUCCESS;
+  }
+
+  std::optional<WorkgroupSize> Device_impl::GetTunedWorkgroupSize(const std::string &name)
+  {
+    std::lock_guard<std::mutex> lock(tune_mutex);
+    auto it = tuned_workgroups.find(name);
+    if (it == tuned_workgroups.end())
+      return {};
+
+    return it->second;
+  }
+
+  void Device_impl::SetTunedWorkgroupSize(const std::string &name, const WorkgroupSize size)
+  {
+    if (name.empty() || name.find_first_of(" \t\n") != std::string::npos)
+    {
+      Logger::EchoError("Invalid autotune name", __func__);
+      return;
+    }
+
+    std::lock_guard<std::mutex> lock(tune_mutex);
+    tuned_workgroups[name] = size;
+  }
+
+  bool Device_impl::CheckPipelineCacheHeader(const std::vector<char> &data) const noexcept
+  {
+    VkPipelineCacheHeaderVersionOne header = {};
+    if (data.size() < sizeof(header))
+      return false;
+
+    std::memcpy(&header, data.data(), sizeof(header));
+    return header.headerSize >= sizeof(header) &&
+           header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+           header.vendorID == p_device.device_properties.vendorID &&
+           header.deviceID == p_device.device_properties.deviceID &&
+           std::memcmp(header.pipelineCacheUUID, p_device.device_properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+  }
+
+  void Device_impl::CreatePipelineCache()
+  {
+    std::vector<char> data;
+    if (auto path = GetPipelineCachePath(); !path.empty() && std::filesystem::exists(path))
+    {
+      std::ifstream f(path, std::ios::ate | std::ios::binary);
+      if (f.is_open())
+      {
+        data.resize((size_t) f.tellg());
+        f.seekg(0);
+        f.read(data.data(), data.size());
+      }
+
+      if (!CheckPipelineCacheHeader(data))
+      {
+        Logger::EchoWarning("Pipeline cache file does not match the device, ignoring it", __func__);
+        data.clear();
+      }
+    }
+
+    VkPipelineCacheCreateInfo info = {};
+    info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    info.initialDataSize = data.size();
+    info.pInitialData = data.empty() ? nullptr : data.data();
+
+    if (auto er = vkCreatePipelineCache(device, &info, nullptr, &pipeline_cache); er != VK_SUCCESS)
+    {
+      Logger::EchoWarning("Can't create pipeline cache", __func__);
+      Logger::EchoDebug("Return code = " + std::to_string(er), __func__);
+      pipeline_cache = VK_NULL_HANDLE;
+    }
+  }
+
+  VkResult Device_impl::SavePipelineCache() const
+  {
+    auto path = GetPipelineCachePath();
+    if (path.empty() || pipeline_cache == VK_NULL_HANDLE)
+      return VK_SUCCESS;
+
+    size_t size = 0;
+    if (auto er = vkGetPipelineCacheData(device, pipeline_cache, &size, nullptr); er != VK_SUCCESS)
+      return er;
+
+    std::vector<char> data(size);
+    if (auto er = vkGetPipelineCacheData(device, pipeline_cache, &size, data.data()); er != VK_SUCCESS && er != VK_INCOMPLETE)
+      return er;
+    data.resize(size);
+
+    try
+    {
+      std::filesystem::create_directories(pipeline_cache_dir);
+      auto tmp_path = path;
+      tmp_path += ".tmp";
+      {
+        std::ofstream f(tmp_path, std::ios::binary | std::ios::trunc);
+        if (!f.is_open())
+        {
+          Logger::EchoError("Can't open pipeline cache file", __func__);
+          return VK_ERROR_INITIALIZATION_FAILED;
+        }
+        f.write(data.data(), data.size());
+      }
+      std::filesystem::rename(tmp_path, path);
+    }
+    catch (...)
+    {
+      Logger::EchoError("Can't save pipeline cache", __func__);
+      return VK_ERROR_INITIALIZATION_FAILED;
+    }
+
+    return VK_SUCCESS;
   }
 
   VkDevice Device_impl::Create(const VkPhysicalDeviceFeatures features)
@@ -342,13 +560,19 @@ namespace Vulkan
 
     VkDeviceCreateInfo device_create_info = {};
     std::vector<VkDeviceQueueCreateInfo> queue_create_infos;
+    std::map<uint32_t, uint32_t> queue_counts;
+    std::map<uint32_t, std::vector<float>> queue_priorities;
     for (auto& family : min_queues)
     {
+      uint32_t count = std::min(queues_per_family, family.second.props.queueCount);
+      queue_counts[(uint32_t) family.first] = count;
+      queue_priorities[(uint32_t) family.first] = std::vector<float>(count, family.second.queue_priority);
+
       VkDeviceQueueCreateInfo queue_create_info = {};
       queue_create_info.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
       queue_create_info.queueFamilyIndex = family.first;
-      queue_create_info.queueCount = 1;
-      queue_create_info.pQueuePriorities = &family.second.queue_priority;
+      queue_create_info.queueCount = count;
+      queue_create_info.pQueuePriorities = queue_priorities[(uint32_t) family.first].data();
       queue_create_infos.push_back(queue_create_info);
     }
 
@@ -359,6 +583,29 @@ namespace Vulkan
     device_create_info.enabledLayerCount = (uint32_t)Misc::RequiredLayers.size();
     device_create_info.ppEnabledLayerNames = Misc::RequiredLayers.data();
 
+    auto supported_features12 = GetSupportedVulkan12Features();
+    VkPhysicalDeviceVulkan12Features features12 = {};
+    features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    features12.timelineSemaphore = supported_features12.timelineSemaphore;
+    features12.drawIndirectCount = supported_features12.drawIndirectCount;
+    features12.descriptorIndexing = supported_features12.descriptorIndexing;
+    features12.runtimeDescriptorArray = supported_features12.runtimeDescriptorArray;
+    features12.descriptorBindingPartiallyBound = supported_features12.descriptorBindingPartiallyBound;
+    features12.descriptorBindingVariableDescriptorCount = supported_features12.descriptorBindingVariableDescriptorCount;
+    features12.descriptorBindingUpdateUnusedWhilePending = supported_features12.descriptorBindingUpdateUnusedWhilePending;
+    features12.descriptorBindingStorageBufferUpdateAfterBind = supported_features12.descriptorBindingStorageBufferUpdateAfterBind;
+    features12.descriptorBindingSampledImageUpdateAfterBind = supported_features12.descriptorBindingSampledImageUpdateAfterBind;
+    features12.descriptorBindingStorageImageUpdateAfterBind = supported_features12.descriptorBindingStorageImageUpdateAfterBind;
+    features12.descriptorBindingUniformBufferUpdateAfterBind = supported_features12.descriptorBindingUniformBufferUpdateAfterBind;
+    features12.descriptorBindingUniformTexelBufferUpdateAfterBind = supported_features12.descriptorBindingUniformTexelBufferUpdateAfterBind;
+    features12.descriptorBindingStorageTexelBufferUpdateAfterBind = supported_features12.descriptorBindingStorageTexelBufferUpdateAfterBind;
+    features12.shaderStorageBufferArrayNonUniformIndexing = supported_features12.shaderStorageBufferArrayNonUniformIndexing;
+    features12.shaderSampledImageArrayNonUniformIndexing = supported_features12.shaderSampledImageArrayNonUniformIndexing;
+    features12.shaderStorageImageArrayNonUniformIndexing = supported_features12.shaderStorageImageArrayNonUniformIndexing;
+
+    if (Instance::GetApiVersion() >= VK_API_VERSION_1_2 && p_device.device_properties.apiVersion >= VK_API_VERSION_1_2)
+      device_create_info.pNext = &features12;
+
     if (queue_flag_bits == QueueType::DrawingType || queue_flag_bits == QueueType::DrawingAndComputeType)
     {
       device_create_info.enabledExtensionCount = (uint32_t)Misc::RequiredGraphicDeviceExtensions.size();
@@ -376,6 +623,8 @@ namespace Vulkan
     else
     {
       req_p_device_features = features;
+      enabled_features12 = features12;
+      family_queue_counts = queue_counts;
       Logger::EchoDebug("Device has created, name = " + std::string(p_device.device_properties.deviceName), __func__);
     }
     
@@ -495,6 +744,96 @@ namespace Vulkan
     return ret;
   }
 
+  VkQueue Device_impl::GetTransferQueue() const
+  {
+    if (auto family = GetTransferFamilyQueueIndex(); family.has_value())
+      return GetQueue(family.value(), 0);
+
+    return VK_NULL_HANDLE;
+  }
+
+  VkQueue Device_impl::GetAsyncComputeQueue() const
+  {
+    if (auto family = GetAsyncComputeFamilyQueueIndex(); family.has_value())
+      return GetQueue(family.value(), 0);
+
+    return VK_NULL_HANDLE;
+  }
+
+  std::optional<uint32_t> Device_impl::GetTransferFamilyQueueIndex() const
+  {
+    for (auto &q : queues)
+    {
+      if (q.purpose == QueuePurpose::TransferPurpose && q.family.has_value())
+        return q.family.value();
+    }
+
+    if (auto family = GetComputeFamilyQueueIndex(); family.has_value())
+      return family;
+
+    return GetGraphicFamilyQueueIndex();
+  }
+
+  std::optional<uint32_t> Device_impl::GetAsyncComputeFamilyQueueIndex() const
+  {
+    if (queue_flag_bits == QueueType::ComputeType || queue_flag_bits == QueueType::DrawingAndComputeType)
+    {
+      for (auto &q : queues)
+      {
+        if (q.purpose == QueuePurpose::AsyncComputePurpose && q.family.has_value())
+          return q.family.value();
+      }
+    }
+
+    return GetComputeFamilyQueueIndex();
+  }
+
+  bool Device_impl::HasDedicatedQueue(const QueuePurpose purpose) const noexcept
+  {
+    for (auto &q : queues)
+    {
+      if (q.purpose == purpose && q.family.has_value())
+        return true;
+    }
+
+    return false;
+  }
+
+  uint32_t Device_impl::GetFamilyQueuesCount(const uint32_t family_index) const noexcept
+  {
+    auto it = family_queue_counts.find(family_index);
+    return it != family_queue_counts.end() ? it->second : 0;
+  }
+
+  VkQueueFamilyProperties Device_impl::GetFamilyQueueProperties(const uint32_t family_index) const
+  {
+    uint32_t family_queues_count = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(p_device.device, &family_queues_count, nullptr);
+    if (family_index >= family_queues_count)
+    {
+      Logger::EchoError("Queue family index is out of range", __func__);
+      return {};
+    }
+
+    std::vector<VkQueueFamilyProperties> queue_families(family_queues_count);
+    vkGetPhysicalDeviceQueueFamilyProperties(p_device.device, &family_queues_count, queue_families.data());
+
+    return queue_families[family_index];
+  }
+
+  VkQueue Device_impl::GetQueue(const uint32_t family_index, const uint32_t queue_index) const
+  {
+    if (queue_index >= GetFamilyQueuesCount(family_index))
+    {
+      Logger::EchoError("Queue index is out of range", __func__);
+      return VK_NULL_HANDLE;
+    }
+
+    VkQueue q = VK_NULL_HANDLE;
+    vkGetDeviceQueue(device, family_index, queue_index, &q);
+    return q;
+  }
+
   VkFormatProperties Device_impl::GetFormatProperties(const VkFormat format) const
   {
     VkFormatProperties format_properties;
@@ -509,6 +848,294 @@ namespace Vulkan
             p_device.device_properties.limits.framebufferDepthSampleCounts) & x;
   }
 
+  VkFence Device_impl::AcquireFence(const VkFenceCreateFlags flags)
+  {
+    {
+      std::lock_guard<std::mutex> lock(sync_mutex);
+      auto &fences = free_fences[flags];
+      if (!fences.empty())
+      {
+        VkFence fence = fences.back();
+        fences.pop_back();
+        return fence;
+      }
+    }
+
+    VkFenceCreateInfo info = {};
+    info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    info.flags = flags;
+
+    VkFence fence = VK_NULL_HANDLE;
+    if (auto er = vkCreateFence(device, &info, nullptr, &fence); er != VK_SUCCESS)
+    {
+      Logger::EchoError("Failed to create fence", __func__);
+      Logger::EchoDebug("Return code = " + std::to_string(er), __func__);
+      return VK_NULL_HANDLE;
+    }
+
+    return fence;
+  }
+
+  void Device_impl::ReleaseFence(const VkFence fence, const VkFenceCreateFlags flags)
+  {
+    if (fence == VK_NULL_HANDLE)
+      return;
+
+    bool reusable = (flags & VK_FENCE_CREATE_SIGNALED_BIT) ? vkGetFenceStatus(device, fence) == VK_SUCCESS : vkResetFences(device, 1, &fence) == VK_SUCCESS;
+    if (!reusable)
+    {
+      vkDestroyFence(device, fence, nullptr);
+      return;
+    }
+
+    std::lock_guard<std::mutex> lock(sync_mutex);
+    free_fences[flags].push_back(fence);
+  }
+
+  VkSemaphore Device_impl::AcquireSemaphore(const VkSemaphoreCreateFlags flags)
+  {
+    {
+      std::lock_guard<std::mutex> lock(sync_mutex);
+      auto &semaphores = free_semaphores[flags];
+      if (!semaphores.empty())
+      {
+        VkSemaphore sem = semaphores.back();
+        semaphores.pop_back();
+        return sem;
+      }
+    }
+
+    VkSemaphoreCreateInfo info = {};
+    info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    info.flags = flags;
+
+    VkSemaphore sem = VK_NULL_HANDLE;
+    if (auto er = vkCreateSemaphore(device, &info, nullptr, &sem); er != VK_SUCCESS)
+    {
+      Logger::EchoError("Failed to create semaphore", __func__);
+      Logger::EchoDebug("Return code = " + std::to_string(er), __func__);
+      return VK_NULL_HANDLE;
+    }
+
+    return sem;
+  }
+
+  void Device_impl::ReleaseSemaphore(const VkSemaphore sem, const VkSemaphoreCreateFlags flags, const bool waited)
+  {
+    if (sem == VK_NULL_HANDLE)
+      return;
+
+    if (!waited)
+    {
+      vkDestroySemaphore(device, sem, nullptr);
+      return;
+    }
+
+    std::lock_guard<std::mutex> lock(sync_mutex);
+    free_semaphores[flags].push_back(sem);
+  }
+
+  void Device_impl::ClearSyncPools() noexcept
+  {
+    std::lock_guard<std::mutex> lock(sync_mutex);
+    for (auto &f : free_fences)
+      for (auto fence : f.second)
+        vkDestroyFence(device, fence, nullptr);
+    for (auto &s : free_semaphores)
+      for (auto sem : s.second)
+        vkDestroySemaphore(device, sem, nullptr);
+    free_fences.clear();
+    free_semaphores.clear();
+  }
+
+  std::vector<char> Device_impl::LoadShaderCode(const std::filesystem::path &file_path)
+  {
+    std::error_code ec;
+    auto write_time = std::filesystem::last_write_time(file_path, ec);
+    if (ec)
+    {
+      Logger::EchoError("No shader file (" + file_path.string() + ")", __func__);
+      return {};
+    }
+
+    auto key = std::filesystem::absolute(file_path, ec).lexically_normal().string();
+    {
+      std::lock_guard<std::mutex> lock(shader_mutex);
+      auto it = shader_files.find(key);
+      if (it != shader_files.end() && it->second.write_time == write_time)
+        return *it->second.code;
+    }
+
+    auto code = std::make_shared<const std::vector<char>>(Misc::LoadShaderFromFile(file_path.string()));
+    if (code->empty())
+      return {};
+
+    std::lock_guard<std::mutex> lock(shader_mutex);
+    shader_files[key] = { write_time, code };
+    return *code;
+  }
+
+  VkShaderModule Device_impl::AcquireShaderModule(const std::vector<char> &code)
+  {
+    if (code.empty())
+    {
+      Logger::EchoError("Shader code is empty", __func__);
+      return VK_NULL_HANDLE;
+    }
+
+    auto hash = std::hash<std::string_view>{}(std::string_view(code.data(), code.size()));
+
+    std::lock_guard<std::mutex> lock(shader_mutex);
+    auto it = shader_modules.find(hash);
+    if (it != shader_modules.end())
+    {
+      if (*it->second.code == code)
+      {
+        it->second.refs++;
+        return it->second.module;
+      }
+
+      Logger::EchoDebug("Shader hash collision, module is not cached", __func__);
+      return Misc::CreateShaderModule(device, code);
+    }
+
+    ShaderModule entry;
+    entry.module = Misc::CreateShaderModule(device, code);
+    if (entry.module == VK_NULL_HANDLE)
+      return VK_NULL_HANDLE;
+
+    entry.code = std::make_shared<const std::vector<char>>(code);
+    entry.refs = 1;
+    shader_modules[hash] = entry;
+    return entry.module;
+  }
+
+  void Device_impl::ReleaseShaderModule(const VkShaderModule module)
+  {
+    if (module == VK_NULL_HANDLE)
+      return;
+
+    std::lock_guard<std::mutex> lock(shader_mutex);
+    auto it = std::find_if(shader_modules.begin(), shader_modules.end(), [module] (const auto &m) { return m.second.module == module; });
+    if (it == shader_modules.end())
+    {
+      vkDestroyShaderModule(device, module, nullptr);
+      return;
+    }
+
+    if (--it->second.refs == 0)
+    {
+      vkDestroyShaderModule(device, module, nullptr);
+      shader_modules.erase(it);
+    }
+  }
+
+  size_t Device_impl::GetShaderModulesCount() noexcept
+  {
+    std::lock_guard<std::mutex> lock(shader_mutex);
+    return shader_modules.size();
+  }
+
+  void Device_impl::ClearShaderModules() noexcept
+  {
+    std::lock_guard<std::mutex> lock(shader_mutex);
+    for (auto &m : shader_modules)
+      vkDestroyShaderModule(device, m.second.module, nullptr);
+    shader_modules.clear();
+    shader_files.clear();
+  }
+
+  std::string Device_impl::GetSetLayoutKey(const VkDescriptorSetLayoutCreateInfo &info)
+  {
+    const VkDescriptorBindingFlags *binding_flags = nullptr;
+    for (auto next = (const VkBaseInStructure *) info.pNext; next != nullptr; next = next->pNext)
+    {
+      if (next->sType == VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO)
+        binding_flags = ((const VkDescriptorSetLayoutBindingFlagsCreateInfo *) next)->pBindingFlags;
+    }
+
+    std::vector<uint32_t> order(info.bindingCount);
+    for (uint32_t i = 0; i < info.bindingCount; ++i)
+      order[i] = i;
+    std::sort(order.begin(), order.end(), [&info] (auto a, auto b) { return info.pBindings[a].binding < info.pBindings[b].binding; });
+
+    std::string result;
+    auto append = [&result] (const auto &value) { result.append((const char *) &value, sizeof(value)); };
+    append(info.flags);
+    for (auto i : order)
+    {
+      auto &b = info.pBindings[i];
+      append(b.binding);
+      append(b.descriptorType);
+      append(b.descriptorCount);
+      append(b.stageFlags);
+      append(binding_flags != nullptr ? binding_flags[i] : (VkDescriptorBindingFlags) 0);
+      for (uint32_t j = 0; b.pImmutableSamplers != nullptr && j < b.descriptorCount; ++j)
+        append(b.pImmutableSamplers[j]);
+    }
+
+    return result;
+  }
+
+  VkDescriptorSetLayout Device_impl::AcquireDescriptorSetLayout(const VkDescriptorSetLayoutCreateInfo &info)
+  {
+    auto key = GetSetLayoutKey(info);
+
+    std::lock_guard<std::mutex> lock(layout_mutex);
+    auto it = set_layouts.find(key);
+    if (it != set_layouts.end())
+    {
+      it->second.refs++;
+      return it->second.layout;
+    }
+
+    SetLayout entry;
+    if (auto er = vkCreateDescriptorSetLayout(device, &info, nullptr, &entry.layout); er != VK_SUCCESS)
+    {
+      Logger::EchoError("Can't create DescriptorSetLayout", __func__);
+      Logger::EchoDebug("Return code = " + std::to_string(er), __func__);
+      return VK_NULL_HANDLE;
+    }
+
+    entry.refs = 1;
+    set_layouts[key] = entry;
+    return entry.layout;
+  }
+
+  void Device_impl::ReleaseDescriptorSetLayout(const VkDescriptorSetLayout layout)
+  {
+    if (layout == VK_NULL_HANDLE)
+      return;
+
+    std::lock_guard<std::mutex> lock(layout_mutex);
+    auto it = std::find_if(set_layouts.begin(), set_layouts.end(), [layout] (const auto &l) { return l.second.layout == layout; });
+    if (it == set_layouts.end())
+    {
+      vkDestroyDescriptorSetLayout(device, layout, nullptr);
+      return;
+    }
+
+    if (--it->second.refs == 0)
+    {
+      vkDestroyDescriptorSetLayout(device, layout, nullptr);
+      set_layouts.erase(it);
+    }
+  }
+
+  size_t Device_impl::GetDescriptorSetLayoutsCount() noexcept
+  {
+    std::lock_guard<std::mutex> lock(layout_mutex);
+    return set_layouts.size();
+  }
+
+  void Device_impl::ClearDescriptorSetLayouts() noexcept
+  {
+    std::lock_guard<std::mutex> lock(layout_mutex);
+    for (auto &l : set_layouts)
+      vkDestroyDescriptorSetLayout(device, l.second.layout, nullptr);
+    set_layouts.clear();
+  }
+
   VkQueue Device_impl::GetQueueFormFamilyIndex(const uint32_t index) const
   {
     VkQueue q;
@@ -525,6 +1152,8 @@ namespace Vulkan
     conf.SetQueueType(obj.impl->queue_flag_bits);
     conf.SetRequiredDeviceFeatures(obj.impl->req_p_device_features);
     conf.SetSurface(obj.impl->surface);
+    conf.SetQueuesPerFamily(obj.impl->queues_per_family);
+    conf.SetPipelineCacheDirectory(obj.impl->pipeline_cache_dir);
     impl = std::unique_ptr<Device_impl>(new Device_impl(conf));
 
     return *this;
@@ -538,6 +1167,8 @@ namespace Vulkan
     conf.SetQueueType(obj.impl->queue_flag_bits);
     conf.SetRequiredDeviceFeatures(obj.impl->req_p_device_features);
     conf.SetSurface(obj.impl->surface);
+    conf.SetQueuesPerFamily(obj.impl->queues_per_family);
+    conf.SetPipelineCacheDirectory(obj.impl->pipeline_cache_dir);
     impl = std::unique_ptr<Device_impl>(new Device_impl(conf));
   }
 
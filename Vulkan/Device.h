@@ -5,6 +5,7 @@
 #include "Misc.h"
 #include "Instance.h"
 #include "Surface.h"
+#include "Pipelines/Types.h"
 
 #include <vulkan/vulkan.h>
 #include <memory>
@@ -12,6 +13,12 @@
 #include <vector>
 #include <iostream>
 #include <map>
+#include <mutex>
+#include <filesystem>
+#include <sstream>
+#include <iomanip>
+#include <cstring>
+#include <string_view>
 
 namespace Vulkan
 { 
@@ -27,7 +34,9 @@ namespace Vulkan
     ComputePurpose,
     PresentationPurpose,
     GraphicPurpose,
-    PresentationAndGraphicPurpose
+    PresentationAndGraphicPurpose,
+    TransferPurpose,
+    AsyncComputePurpose
   };
 
   enum class PhysicalDeviceType
@@ -64,6 +73,8 @@ namespace Vulkan
     PhysicalDeviceType p_device_type = PhysicalDeviceType::Discrete;
     VkPhysicalDeviceFeatures p_device_features = {};
     std::string device_name = "";
+    uint32_t queues_per_family = 1;
+    std::filesystem::path pipeline_cache_dir;
   public:
     DeviceConfig() = default;
     ~DeviceConfig() noexcept = default;
@@ -73,6 +84,8 @@ namespace Vulkan
     auto &SetDeviceType(const PhysicalDeviceType type) noexcept { p_device_type = type; return *this; }
     auto &SetDeviceName(const std::string name) { device_name = name; return *this; }
     auto &SetRequiredDeviceFeatures(const VkPhysicalDeviceFeatures features) noexcept { p_device_features = features; return *this; }
+    auto &SetQueuesPerFamily(const uint32_t count) noexcept { queues_per_family = count; return *this; }
+    auto &SetPipelineCacheDirectory(const std::filesystem::path dir) { pipeline_cache_dir = dir; return *this; }
   };
 
   class Device_impl
@@ -89,13 +102,50 @@ namespace Vulkan
     std::shared_ptr<Surface> surface;
     PhysicalDevice p_device = {};
     VkPhysicalDeviceFeatures req_p_device_features = {};
+    VkPhysicalDeviceVulkan12Features enabled_features12 = {};
     VkDevice device = VK_NULL_HANDLE;
     QueueType queue_flag_bits = QueueType::ComputeType;
     std::vector<Queue> queues;
+    std::map<uint32_t, uint32_t> family_queue_counts;
+    uint32_t queues_per_family = 1;
+    std::mutex sync_mutex;
+    std::map<VkFenceCreateFlags, std::vector<VkFence>> free_fences;
+    std::map<VkSemaphoreCreateFlags, std::vector<VkSemaphore>> free_semaphores;
+    std::filesystem::path pipeline_cache_dir;
+    VkPipelineCache pipeline_cache = VK_NULL_HANDLE;
+    struct ShaderFile
+    {
+      std::filesystem::file_time_type write_time;
+      std::shared_ptr<const std::vector<char>> code;
+    };
+    struct ShaderModule
+    {
+      VkShaderModule module = VK_NULL_HANDLE;
+      std::shared_ptr<const std::vector<char>> code;
+      size_t refs = 0;
+    };
+    std::mutex shader_mutex;
+    std::map<std::string, ShaderFile> shader_files;
+    std::map<size_t, ShaderModule> shader_modules;
+    struct SetLayout
+    {
+      VkDescriptorSetLayout layout = VK_NULL_HANDLE;
+      size_t refs = 0;
+    };
+    std::mutex layout_mutex;
+    std::map<std::string, SetLayout> set_layouts;
+    std::mutex tune_mutex;
+    std::map<std::string, WorkgroupSize> tuned_workgroups;
 
     Device_impl(const DeviceConfig params);    
     VkDevice Create(const VkPhysicalDeviceFeatures features);
+    void CreatePipelineCache();
+    bool CheckPipelineCacheHeader(const std::vector<char> &data) const noexcept;
+    std::filesystem::path GetPipelineCachePath() const;
+    std::filesystem::path GetAutotunePath() const;
+    void LoadAutotuneResults();
     std::vector<Queue> FindFamilyQueues() const;
+    VkPhysicalDeviceVulkan12Features GetSupportedVulkan12Features() const;
 
     static std::vector<VkPhysicalDevice> GetAllPhysicalDevices();
     static VkDeviceSize GetPhisicalDevicesCount();
@@ -107,12 +157,44 @@ namespace Vulkan
     std::optional<uint32_t> GetPresentFamilyQueueIndex() const;
     std::optional<uint32_t> GetComputeFamilyQueueIndex() const;
     VkQueue GetQueueFormFamilyIndex(const uint32_t index) const;
+    VkQueue GetTransferQueue() const;
+    VkQueue GetAsyncComputeQueue() const;
+    std::optional<uint32_t> GetTransferFamilyQueueIndex() const;
+    std::optional<uint32_t> GetAsyncComputeFamilyQueueIndex() const;
+    bool HasDedicatedQueue(const QueuePurpose purpose) const noexcept;
+    uint32_t GetFamilyQueuesCount(const uint32_t family_index) const noexcept;
+    VkQueueFamilyProperties GetFamilyQueueProperties(const uint32_t family_index) const;
+    VkQueue GetQueue(const uint32_t family_index, const uint32_t queue_index) const;
     VkPhysicalDeviceProperties GetPhysicalDeviceProperties() const noexcept { return p_device.device_properties; }
     VkPhysicalDevice GetPhysicalDevice() const noexcept { return p_device.device; }
     std::shared_ptr<Surface> GetSurface() const noexcept { return surface; }
     VkDevice GetDevice() const noexcept { return device; }
     VkFormatProperties GetFormatProperties(const VkFormat format) const;
+    VkPhysicalDeviceFeatures GetEnabledFeatures() const noexcept { return p_device.device_features; }
+    VkPhysicalDeviceVulkan12Features GetEnabledVulkan12Features() const noexcept { return enabled_features12; }
     bool CheckMultisampling(VkSampleCountFlagBits x) const noexcept;
+    VkFence AcquireFence(const VkFenceCreateFlags flags);
+    void ReleaseFence(const VkFence fence, const VkFenceCreateFlags flags);
+    VkSemaphore AcquireSemaphore(const VkSemaphoreCreateFlags flags);
+    void ReleaseSemaphore(const VkSemaphore sem, const VkSemaphoreCreateFlags flags, const bool waited);
+    void ClearSyncPools() noexcept;
+    VkPipelineCache GetPipelineCache() const noexcept { return pipeline_cache; }
+    std::filesystem::path GetShaderCacheDirectory() const { return pipeline_cache_dir.empty() ? std::filesystem::path() : pipeline_cache_dir / "spirv"; }
+    VkResult SavePipelineCache() const;
+    std::vector<char> LoadShaderCode(const std::filesystem::path &file_path);
+    VkShaderModule AcquireShaderModule(const std::vector<char> &code);
+    void ReleaseShaderModule(const VkShaderModule module);
+    size_t GetShaderModulesCount() noexcept;
+    void ClearShaderModules() noexcept;
+    static std::string GetSetLayoutKey(const VkDescriptorSetLayoutCreateInfo &info);
+    VkDescriptorSetLayout AcquireDescriptorSetLayout(const VkDescriptorSetLayoutCreateInfo &info);
+    void ReleaseDescriptorSetLayout(const VkDescriptorSetLayout layout);
+    size_t GetDescriptorSetLayoutsCount() noexcept;
+    void ClearDescriptorSetLayouts() noexcept;
+    std::string GetDeviceUUID() const;
+    std::optional<WorkgroupSize> GetTunedWorkgroupSize(const std::string &name);
+    void SetTunedWorkgroupSize(const std::string &name, const WorkgroupSize size);
+    VkResult SaveAutotuneResults();
   };
 
   class Device
@@ -136,12 +218,42 @@ namespace Vulkan
     std::optional<uint32_t> GetPresentFamilyQueueIndex() const { if (impl.get()) return impl->GetPresentFamilyQueueIndex(); return {}; }
     std::optional<uint32_t> GetComputeFamilyQueueIndex() const { if (impl.get()) return impl->GetComputeFamilyQueueIndex(); return {}; }
     VkQueue GetQueueFormFamilyIndex(const uint32_t index) const { if (impl.get()) return impl->GetQueueFormFamilyIndex(index); return VK_NULL_HANDLE; }
+    VkQueue GetTransferQueue() const { if (impl.get()) return impl->GetTransferQueue(); return VK_NULL_HANDLE; }
+    VkQueue GetAsyncComputeQueue() const { if (impl.get()) return impl->GetAsyncComputeQueue(); return VK_NULL_HANDLE; }
+    std::optional<uint32_t> GetTransferFamilyQueueIndex() const { if (impl.get()) return impl->GetTransferFamilyQueueIndex(); return {}; }
+    std::optional<uint32_t> GetAsyncComputeFamilyQueueIndex() const { if (impl.get()) return impl->GetAsyncComputeFamilyQueueIndex(); return {}; }
+    bool HasDedicatedQueue(const QueuePurpose purpose) const noexcept { if (impl.get()) return impl->HasDedicatedQueue(purpose); return false; }
+    uint32_t GetFamilyQueuesCount(const uint32_t family_index) const noexcept { if (impl.get()) return impl->GetFamilyQueuesCount(family_index); return 0; }
+    VkQueueFamilyProperties GetFamilyQueueProperties(const uint32_t family_index) const { if (impl.get()) return impl->GetFamilyQueueProperties(family_index); return {}; }
+    VkQueue GetQueue(const uint32_t family_index, const uint32_t queue_index) const { if (impl.get()) return impl->GetQueue(family_index, queue_index); return VK_NULL_HANDLE; }
     VkPhysicalDeviceProperties GetPhysicalDeviceProperties() const noexcept { if (impl.get()) return impl->GetPhysicalDeviceProperties(); return {}; }
     VkPhysicalDevice GetPhysicalDevice() const noexcept { if (impl.get()) return impl->GetPhysicalDevice(); return VK_NULL_HANDLE; }
     std::shared_ptr<Surface> GetSurface() const noexcept { if (impl.get()) return impl->GetSurface(); return {}; }
     VkDevice GetDevice() const noexcept { if (impl.get()) return impl->GetDevice(); return VK_NULL_HANDLE; }
     VkFormatProperties GetFormatProperties(const VkFormat format) const { if (impl.get()) return impl->GetFormatProperties(format); return {}; }
+    VkPhysicalDeviceFeatures GetEnabledFeatures() const noexcept { if (impl.get()) return impl->GetEnabledFeatures(); return {}; }
+    VkPhysicalDeviceVulkan12Features GetEnabledVulkan12Features() const noexcept { if (impl.get()) return impl->GetEnabledVulkan12Features(); return {}; }
     VkBool32 CheckSampleCountSupport(VkSampleCountFlagBits x) const noexcept { if (impl.get()) return impl->CheckMultisampling(x); return false; }
+    VkFence AcquireFence(const VkFenceCreateFlags flags = 0) { if (impl.get()) return impl->AcquireFence(flags); return VK_NULL_HANDLE; }
+    void ReleaseFence(const VkFence fence, const VkFenceCreateFlags flags = 0) { if (impl.get()) impl->ReleaseFence(fence, flags); }
+    VkSemaphore AcquireSemaphore(const VkSemaphoreCreateFlags flags = 0) { if (impl.get()) return impl->AcquireSemaphore(flags); return VK_NULL_HANDLE; }
+    // Only semaphores whose last signal has been waited on are pooled, the rest are destroyed
+    void ReleaseSemaphore(const VkSemaphore sem, const VkSemaphoreCreateFlags flags = 0, const bool waited = false) { if (impl.get()) impl->ReleaseSemaphore(sem, flags, waited); }
+    void ClearSyncPools() noexcept { if (impl.get()) impl->ClearSyncPools(); }
+    VkPipelineCache GetPipelineCache() const noexcept { if (impl.get()) return impl->GetPipelineCache(); return VK_NULL_HANDLE; }
+    std::filesystem::path GetShaderCacheDirectory() const { if (impl.get()) return impl->GetShaderCacheDirectory(); return {}; }
+    VkResult SavePipelineCache() const { if (impl.get()) return impl->SavePipelineCache(); return VK_ERROR_UNKNOWN; }
+    std::vector<char> LoadShaderCode(const std::filesystem::path &file_path) { if (impl.get()) return impl->LoadShaderCode(file_path); return {}; }
+    VkShaderModule AcquireShaderModule(const std::vector<char> &code) { if (impl.get()) return impl->AcquireShaderModule(code); return VK_NULL_HANDLE; }
+    void ReleaseShaderModule(const VkShaderModule module) { if (impl.get()) impl->ReleaseShaderModule(module); }
+    size_t GetShaderModulesCount() const noexcept { if (impl.get()) return impl->GetShaderModulesCount(); return 0; }
+    VkDescriptorSetLayout AcquireDescriptorSetLayout(const VkDescriptorSetLayoutCreateInfo &info) { if (impl.get()) return impl->AcquireDescriptorSetLayout(info); return VK_NULL_HANDLE; }
+    void ReleaseDescriptorSetLayout(const VkDescriptorSetLayout layout) { if (impl.get()) impl->ReleaseDescriptorSetLayout(layout); }
+    size_t GetDescriptorSetLayoutsCount() const noexcept { if (impl.get()) return impl->GetDescriptorSetLayoutsCount(); return 0; }
+    std::string GetDeviceUUID() const { if (impl.get()) return impl->GetDeviceUUID(); return {}; }
+    std::optional<WorkgroupSize> GetTunedWorkgroupSize(const std::string &name) const { if (impl.get()) return impl->GetTunedWorkgroupSize(name); return {}; }
+    void SetTunedWorkgroupSize(const std::string &name, const WorkgroupSize size) { if (impl.get()) impl->SetTunedWorkgroupSize(name, size); }
+    VkResult SaveAutotuneResults() const { if (impl.get()) return impl->SaveAutotuneResults(); return VK_ERROR_UNKNOWN; }
     bool IsValid() const noexcept { return impl.get() && impl->device != VK_NULL_HANDLE; }
     ~Device() noexcept = default;
   };
@@ -12,23 +12,14 @@ namespace Vulkan
 
     device = dev;
     this->flags = flags;
-
-    VkFenceCreateInfo info = {};
-    info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-    info.flags = this->flags;
-
-    if (auto er = vkCreateFence(device->GetDevice(), &info, nullptr, &fence); er != VK_SUCCESS)
-    {
-      Logger::EchoError("Failed to create fence");
-      Logger::EchoDebug("Return code = " + std::to_string(er), __func__);
-    }
+    fence = device->AcquireFence(this->flags);
   }
 
   Fence_impl::~Fence_impl() noexcept
   {
     Logger::EchoDebug("", __func__);
     if (fence != VK_NULL_HANDLE)
-      vkDestroyFence(device->GetDevice(), fence, nullptr);
+      device->ReleaseFence(fence, flags);
   }
 
   Fence::Fence(const Fence &obj)
@@ -147,18 +138,16 @@ namespace Vulkan
 
   VkResult FenceArray::Add(Fence&& obj)
   {
-    auto ptr = std::shared_ptr<Fence>(new Fence(obj));
-    if (ptr->IsValid() && obj.impl->device == device)
+    if (!obj.IsValid() || obj.impl->device != device)
     {
-      fences.push_back(ptr);
-      p_fences.push_back(ptr->impl->fence);
-      return VK_SUCCESS;
+      Logger::EchoError("Fence is not valid", __func__);
+      return VK_ERROR_UNKNOWN;
     }
 
-    obj = std::move(*ptr);
-    Logger::EchoError("Fence is not valid", __func__);
-
-    return VK_ERROR_UNKNOWN;
+    auto ptr = std::shared_ptr<Fence>(new Fence(std::move(obj)));
+    fences.push_back(ptr);
+    p_fences.push_back(ptr->impl->fence);
+    return VK_SUCCESS;
   }
 
   VkResult FenceArray::WaitFor(const uint64_t timeout, const VkBool32 wait_for_all) const noexcept
@@ -78,6 +78,7 @@ namespace Vulkan
     VkResult WaitFor(const uint64_t timeout = UINT64_MAX, const VkBool32 wait_for_all = VK_TRUE) const noexcept;
     VkResult ResetAll() noexcept;
     size_t Count() const noexcept { return fences.size(); }
+    void Reserve(const size_t count) { p_fences.reserve(count); fences.reserve(count); }
     void Clear() noexcept { p_fences.clear(); fences.clear(); };
     std::shared_ptr<Fence> GetFence(const size_t index) const noexcept { return index < fences.size() ? fences[index] : nullptr; };
     std::shared_ptr<Device> GetDevice() const noexcept { return device; }
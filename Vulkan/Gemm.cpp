@@ -0,0 +1,187 @@
+#include "Gemm.h"
+
+namespace Vulkan
+{
+  Gemm_impl::~Gemm_impl() noexcept
+  {
+    Logger::EchoDebug("", __func__);
+    pipelines.clear();
+    set_cache.Clear();
+    if (device.get() != nullptr && layout != VK_NULL_HANDLE)
+      device->ReleaseDescriptorSetLayout(layout);
+  }
+
+  Gemm_impl::Gemm_impl(std::shared_ptr<Device> dev, const GemmConfig &params) :
+    set_cache(dev, DescriptorSetCacheConfig().SetFramesInFlight(2).SetAllocatorConfig(DescriptorAllocatorConfig().AddPoolRatio(DescriptorType::BufferStorage, 3.0f)))
+  {
+    if (dev.get() == nullptr || !dev->IsValid())
+    {
+      Logger::EchoError("Device is empty", __func__);
+      return;
+    }
+
+    device = dev;
+
+    std::vector<VkDescriptorSetLayoutBinding> bindings(3);
+    for (uint32_t i = 0; i < bindings.size(); ++i)
+    {
+      bindings[i].binding = i;
+      bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+      bindings[i].descriptorCount = 1;
+      bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+
+    VkDescriptorSetLayoutCreateInfo layout_create_info = {};
+    layout_create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layout_create_info.bindingCount = (uint32_t) bindings.size();
+    layout_create_info.pBindings = bindings.data();
+    layout = device->AcquireDescriptorSetLayout(layout_create_info);
+    if (layout == VK_NULL_HANDLE)
+    {
+      Logger::EchoError("Can't create DescriptorSetLayout", __func__);
+      return;
+    }
+
+    for (auto &[kernel, tile] : params.tiles)
+    {
+      if (!IsTileSupported(tile))
+      {
+        Logger::EchoWarning("GEMM tile " + std::to_string((int) kernel) + " is not supported by device", __func__);
+        continue;
+      }
+
+      ComputePipeline pipeline(device, ComputePipelineConfig().AddDescriptorSetLayout(layout)
+                                                              .SetShaderSource(GemmKernels::tiled)
+                                                              .SetSpecializationConstant(0, tile.block_m)
+                                                              .SetSpecializationConstant(1, tile.block_n)
+                                                              .SetSpecializationConstant(2, tile.block_k)
+                                                              .SetSpecializationConstant(3, tile.thread_m)
+                                                              .SetSpecializationConstant(4, tile.thread_n)
+                                                              .SetSpecializationConstant(5, tile.block_n / tile.thread_n)
+                                                              .SetSpecializationConstant(6, tile.block_m / tile.thread_m));
+      if (!pipeline.IsValid())
+      {
+        Logger::EchoError("Can't build GEMM kernel " + std::to_string((int) kernel), __func__);
+        continue;
+      }
+      tiles[kernel] = tile;
+      pipelines.emplace(kernel, std::move(pipeline));
+    }
+  }
+
+  bool Gemm_impl::IsTileSupported(const GemmTile &tile) const
+  {
+    if (tile.block_m == 0 || tile.block_n == 0 || tile.block_k == 0 || tile.thread_m == 0 || tile.thread_n == 0)
+      return false;
+    if (tile.block_m % tile.thread_m != 0 || tile.block_n % tile.thread_n != 0)
+      return false;
+
+    auto limits = device->GetPhysicalDeviceProperties().limits;
+    uint32_t x = tile.block_n / tile.thread_n;
+    uint32_t y = tile.block_m / tile.thread_m;
+    uint64_t shared_size = (uint64_t) (tile.block_m + tile.block_n) * tile.block_k * sizeof(float);
+    return x <= limits.maxComputeWorkGroupSize[0] && y <= limits.maxComputeWorkGroupSize[1] &&
+           (uint64_t) x * y <= limits.maxComputeWorkGroupInvocations && shared_size <= limits.maxComputeSharedMemorySize;
+  }
+
+  GemmKernel Gemm_impl::SelectKernel(const GemmShape &shape) const
+  {
+    std::vector<GemmKernel> order;
+    if (shape.m >= 512 && shape.n >= 512)
+      order = { GemmKernel::Large, GemmKernel::Medium, GemmKernel::Small };
+    else if (shape.m >= 64 && shape.n >= 64)
+      order = { GemmKernel::Medium, GemmKernel::Small, GemmKernel::Large };
+    else
+      order = { GemmKernel::Small, GemmKernel::Medium, GemmKernel::Large };
+
+    for (auto kernel : order)
+      if (pipelines.count(kernel) > 0)
+        return kernel;
+
+    return GemmKernel::Auto;
+  }
+
+  VkResult Gemm_impl::Multiply(CommandBuffer &cmd, const BufferRange &a, const BufferRange &b, const BufferRange &c, const GemmShape &shape, const float alpha, const float beta, const GemmKernel kernel)
+  {
+    if (shape.m == 0 || shape.n == 0 || shape.k == 0)
+    {
+      Logger::EchoError("Matrix size is 0", __func__);
+      return VK_ERROR_UNKNOWN;
+    }
+
+    Params params = { shape.m, shape.n, shape.k, shape.lda ? shape.lda : shape.k, shape.ldb ? shape.ldb : shape.n, shape.ldc ? shape.ldc : shape.n, alpha, beta };
+    if (params.lda < params.k || params.ldb < params.n || params.ldc < params.n)
+    {
+      Logger::EchoError("Leading dimension is less than matrix width", __func__);
+      return VK_ERROR_UNKNOWN;
+    }
+
+    auto required = [] (const uint32_t rows, const uint32_t cols, const uint32_t ld) { return ((uint64_t) (rows - 1) * ld + cols) * sizeof(float); };
+    if (a.buffer == VK_NULL_HANDLE || b.buffer == VK_NULL_HANDLE || c.buffer == VK_NULL_HANDLE ||
+        required(params.m, params.k, params.lda) > a.size || required(params.k, params.n, params.ldb) > b.size || required(params.m, params.n, params.ldc) > c.size)
+    {
+      Logger::EchoError("Buffer is too small for matrix", __func__);
+      return VK_ERROR_UNKNOWN;
+    }
+
+    auto selected = kernel == GemmKernel::Auto ? SelectKernel(shape) : kernel;
+    if (pipelines.count(selected) == 0)
+    {
+      Logger::EchoError("GEMM kernel is not available", __func__);
+      return VK_ERROR_UNKNOWN;
+    }
+
+    LayoutConfig info;
+    const std::array<const BufferRange *, 3> ranges = { &a, &b, &c };
+    for (uint32_t i = 0; i < ranges.size(); ++i)
+    {
+      DescriptorInfo desc_info;
+      desc_info.type = DescriptorType::BufferStorage;
+      desc_info.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+      desc_info.binding = i;
+      desc_info.buffer_info.buffer = ranges[i]->buffer;
+      desc_info.offset = ranges[i]->offset;
+      desc_info.size = ranges[i]->size;
+      info.AddBufferOrImage(desc_info);
+    }
+
+    VkDescriptorSet set = VK_NULL_HANDLE;
+    if (auto er = set_cache.GetDescriptorSet(layout, info, set); er != VK_SUCCESS)
+    {
+      Logger::EchoError("Can't get DescriptorSet", __func__);
+      return er;
+    }
+
+    auto &tile = tiles.at(selected);
+    auto &pipeline = pipelines.at(selected);
+    cmd.ComputeBarrier()
+       .BindPipeline(pipeline)
+       .BindDescriptorSets(pipeline.GetLayout(), VK_PIPELINE_BIND_POINT_COMPUTE, {set}, 0, {})
+       .PushConstants(pipeline.GetLayout(), VK_SHADER_STAGE_COMPUTE_BIT, params)
+       .Dispatch((params.n + tile.block_n - 1) / tile.block_n, (params.m + tile.block_m - 1) / tile.block_m, 1)
+       .ComputeBarrier();
+    return VK_SUCCESS;
+  }
+
+  Gemm &Gemm::operator=(Gemm &&obj) noexcept
+  {
+    if (&obj == this) return *this;
+
+    impl = std::move(obj.impl);
+    return *this;
+  }
+
+  void Gemm::swap(Gemm &obj) noexcept
+  {
+    if (&obj == this) return;
+
+    impl.swap(obj.impl);
+  }
+
+  void swap(Gemm &lhs, Gemm &rhs) noexcept
+  {
+    if (&lhs == &rhs) return;
+
+    lhs.swap(rhs);
+  }
+}
\ No newline at end of file
@@ -0,0 +1,131 @@
+#ifndef __VULKAN_GEMM_H
+#define __VULKAN_GEMM_H
+
+#include "Logger.h"
+#include "Device.h"
+#include "StorageArray.h"
+#include "Descriptors.h"
+#include "DescriptorSetCache.h"
+#include "CommandBuffer.h"
+#include "Pipelines/ComputePipeline.h"
+#include "Gemm/Kernels.h"
+
+#include <vulkan/vulkan.h>
+#include <memory>
+#include <vector>
+#include <array>
+#include <map>
+
+namespace Vulkan
+{
+  enum class GemmKernel
+  {
+    Auto,
+    Small,
+    Medium,
+    Large
+  };
+
+  struct GemmTile
+  {
+    uint32_t block_m = 64;
+    uint32_t block_n = 64;
+    uint32_t block_k = 16;
+    uint32_t thread_m = 4;
+    uint32_t thread_n = 4;
+  };
+
+  struct GemmShape
+  {
+    uint32_t m = 0;
+    uint32_t n = 0;
+    uint32_t k = 0;
+    uint32_t lda = 0;
+    uint32_t ldb = 0;
+    uint32_t ldc = 0;
+  };
+
+  class GemmConfig
+  {
+  private:
+    friend class Gemm_impl;
+    std::map<GemmKernel, GemmTile> tiles = {
+      {GemmKernel::Small, {16, 16, 16, 1, 1}},
+      {GemmKernel::Medium, {64, 64, 16, 4, 4}},
+      {GemmKernel::Large, {128, 128, 8, 8, 8}}
+    };
+  public:
+    GemmConfig() = default;
+    ~GemmConfig() noexcept = default;
+    auto &SetTile(const GemmKernel kernel, const GemmTile &tile) { if (kernel != GemmKernel::Auto) tiles[kernel] = tile; return *this; }
+  };
+
+  class Gemm_impl
+  {
+  public:
+    Gemm_impl() = delete;
+    Gemm_impl(const Gemm_impl &obj) = delete;
+    Gemm_impl(Gemm_impl &&obj) = delete;
+    Gemm_impl &operator=(const Gemm_impl &obj) = delete;
+    Gemm_impl &operator=(Gemm_impl &&obj) = delete;
+    ~Gemm_impl() noexcept;
+  private:
+    friend class Gemm;
+    struct Params
+    {
+      uint32_t m = 0;
+      uint32_t n = 0;
+      uint32_t k = 0;
+      uint32_t lda = 0;
+      uint32_t ldb = 0;
+      uint32_t ldc = 0;
+      float alpha = 1.0f;
+      float beta = 0.0f;
+    };
+
+    std::shared_ptr<Device> device;
+    VkDescriptorSetLayout layout = VK_NULL_HANDLE;
+    std::map<GemmKernel, GemmTile> tiles;
+    std::map<GemmKernel, ComputePipeline> pipelines;
+    DescriptorSetCache set_cache;
+
+    Gemm_impl(std::shared_ptr<Device> dev, const GemmConfig &params);
+    bool IsTileSupported(const GemmTile &tile) const;
+    GemmKernel SelectKernel(const GemmShape &shape) const;
+    VkResult Multiply(CommandBuffer &cmd, const BufferRange &a, const BufferRange &b, const BufferRange &c, const GemmShape &shape, const float alpha, const float beta, const GemmKernel kernel);
+    bool IsKernelAvailable(const GemmKernel kernel) const noexcept { return pipelines.count(kernel) > 0; }
+    void BeginFrame() { set_cache.BeginFrame(); }
+    std::shared_ptr<Device> GetDevice() const noexcept { return device; }
+  };
+
+  class Gemm
+  {
+  private:
+    std::unique_ptr<Gemm_impl> impl;
+  public:
+    Gemm() = delete;
+    Gemm(const Gemm &obj) = delete;
+    Gemm(Gemm &&obj) noexcept : impl(std::move(obj.impl)) {};
+    Gemm(std::shared_ptr<Device> dev, const GemmConfig &params = {}) :
+      impl(std::unique_ptr<Gemm_impl>(new Gemm_impl(dev, params))) {};
+    Gemm &operator=(const Gemm &obj) = delete;
+    Gemm &operator=(Gemm &&obj) noexcept;
+    ~Gemm() noexcept = default;
+    void swap(Gemm &obj) noexcept;
+    bool IsValid() const noexcept { return impl.get() && !impl->pipelines.empty(); }
+
+    VkResult Multiply(CommandBuffer &cmd, const BufferRange &a, const BufferRange &b, const BufferRange &c, const GemmShape &shape, const float alpha = 1.0f, const float beta = 0.0f, const GemmKernel kernel = GemmKernel::Auto) { if (IsValid()) return impl->Multiply(cmd, a, b, c, shape, alpha, beta, kernel); return VK_ERROR_UNKNOWN; }
+    VkResult Multiply(CommandBuffer &cmd, const StorageArray &array, const size_t index, const std::array<size_t, 3> sub_indices, const GemmShape &shape, const float alpha = 1.0f, const float beta = 0.0f, const GemmKernel kernel = GemmKernel::Auto)
+    {
+      return Multiply(cmd, BufferRange::FromSubBuffer(array, index, sub_indices[0]), BufferRange::FromSubBuffer(array, index, sub_indices[1]),
+                      BufferRange::FromSubBuffer(array, index, sub_indices[2]), shape, alpha, beta, kernel);
+    }
+    bool IsKernelAvailable(const GemmKernel kernel) const noexcept { if (impl.get()) return impl->IsKernelAvailable(kernel); return false; }
+    void BeginFrame() { if (IsValid()) impl->BeginFrame(); }
+    std::shared_ptr<Device> GetDevice() const noexcept { if (impl.get()) return impl->GetDevice(); return nullptr; }
+  };
+
+  void swap(Gemm &lhs, Gemm &rhs) noexcept;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,111 @@
+#ifndef __VULKAN_GEMM_KERNELS_H
+#define __VULKAN_GEMM_KERNELS_H
+
+namespace Vulkan
+{
+  struct GemmKernels
+  {
+    static constexpr const char *tiled = R"(
+#version 450
+
+layout(local_size_x_id = 5, local_size_y_id = 6, local_size_z = 1) in;
+
+layout(constant_id = 0) const uint BM = 64;
+layout(constant_id = 1) const uint BN = 64;
+layout(constant_id = 2) const uint BK = 16;
+layout(constant_id = 3) const uint TM = 4;
+layout(constant_id = 4) const uint TN = 4;
+
+layout(std430, binding = 0) readonly buffer MatrixA { float a[]; };
+layout(std430, binding = 1) readonly buffer MatrixB { float b[]; };
+layout(std430, binding = 2) buffer MatrixC { float c[]; };
+
+layout(push_constant) uniform Params
+{
+  uint M;
+  uint N;
+  uint K;
+  uint lda;
+  uint ldb;
+  uint ldc;
+  float alpha;
+  float beta;
+} p;
+
+shared float s_a[BK * BM];
+shared float s_b[BK * BN];
+
+void main()
+{
+  uint tx = gl_LocalInvocationID.x;
+  uint ty = gl_LocalInvocationID.y;
+  uint wgx = gl_WorkGroupSize.x;
+  uint wgy = gl_WorkGroupSize.y;
+  uint threads = wgx * wgy;
+  uint tid = ty * wgx + tx;
+  uint row0 = gl_WorkGroupID.y * BM;
+  uint col0 = gl_WorkGroupID.x * BN;
+
+  float acc[TM * TN];
+  float reg_a[TM];
+  float reg_b[TN];
+  for (uint i = 0; i < TM * TN; ++i)
+    acc[i] = 0.0;
+
+  for (uint k0 = 0; k0 < p.K; k0 += BK)
+  {
+    for (uint i = tid; i < BM * BK; i += threads)
+    {
+      uint r = i / BK;
+      uint k = i % BK;
+      bool inside = row0 + r < p.M && k0 + k < p.K;
+      s_a[k * BM + r] = inside ? a[(row0 + r) * p.lda + k0 + k] : 0.0;
+    }
+
+    for (uint i = tid; i < BK * BN; i += threads)
+    {
+      uint k = i / BN;
+      uint col = i % BN;
+      bool inside = k0 + k < p.K && col0 + col < p.N;
+      s_b[k * BN + col] = inside ? b[(k0 + k) * p.ldb + col0 + col] : 0.0;
+    }
+    barrier();
+
+    for (uint k = 0; k < BK; ++k)
+    {
+      for (uint i = 0; i < TM; ++i)
+        reg_a[i] = s_a[k * BM + ty + i * wgy];
+      for (uint j = 0; j < TN; ++j)
+        reg_b[j] = s_b[k * BN + tx + j * wgx];
+      for (uint i = 0; i < TM; ++i)
+        for (uint j = 0; j < TN; ++j)
+          acc[i * TN + j] = fma(reg_a[i], reg_b[j], acc[i * TN + j]);
+    }
+    barrier();
+  }
+
+  for (uint i = 0; i < TM; ++i)
+  {
+    uint row = row0 + ty + i * wgy;
+    if (row >= p.M)
+      continue;
+
+    for (uint j = 0; j < TN; ++j)
+    {
+      uint col = col0 + tx + j * wgx;
+      if (col >= p.N)
+        continue;
+
+      uint index = row * p.ldc + col;
+      float value = p.alpha * acc[i * TN + j];
+      if (p.beta != 0.0)
+        value += p.beta * c[index];
+      c[index] = value;
+    }
+  }
+}
+)";
+  };
+}
+
+#endif
\ No newline at end of file
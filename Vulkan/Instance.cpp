@@ -6,6 +6,7 @@ namespace Vulkan
   VkDebugUtilsMessengerEXT Instance::debug_messenger = VK_NULL_HANDLE;
   std::string Instance::app_name = "Application";
   std::string Instance::engine_name = "Marisa";
+  uint32_t Instance::api_version = VK_API_VERSION_1_1;
   std::mutex Instance::instance_lock;
 
   std::vector<std::string> Instance::GetInstanceExtensions()
@@ -46,7 +47,10 @@ namespace Vulkan
       app_info.applicationVersion = APP_VERSION;
       app_info.pEngineName = engine_name.c_str();
       app_info.engineVersion = ENGINE_VERSION;
-      app_info.apiVersion = VK_API_VERSION_1_1;
+      uint32_t loader_version = VK_API_VERSION_1_1;
+      if (vkEnumerateInstanceVersion(&loader_version) == VK_SUCCESS && loader_version >= VK_API_VERSION_1_2)
+        api_version = VK_API_VERSION_1_2;
+      app_info.apiVersion = api_version;
 
       VkInstanceCreateInfo create_info = {};
       create_info.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
@@ -80,6 +84,13 @@ namespace Vulkan
     return instance; 
   }
 
+  uint32_t Instance::GetApiVersion()
+  {
+    GetInstance();
+    std::lock_guard<std::mutex> lock(instance_lock);
+    return api_version;
+  }
+
   Instance::~Instance() noexcept
   {
     std::lock_guard<std::mutex> lock(instance_lock);
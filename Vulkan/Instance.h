@@ -21,6 +21,7 @@ namespace Vulkan
     static VkDebugUtilsMessengerEXT debug_messenger;
     static std::string app_name;
     static std::string engine_name;
+    static uint32_t api_version;
     static std::mutex instance_lock;
     static std::vector<std::string> GetInstanceExtensions();
   public:
@@ -30,6 +31,7 @@ namespace Vulkan
     Instance& operator= (const Instance &obj) = delete;
     Instance& operator= (Instance &&obj) = delete;
     static std::string AppName() noexcept { return app_name; }
+    static uint32_t GetApiVersion();
     static VkInstance& GetInstance();
     ~Instance() noexcept;
   };
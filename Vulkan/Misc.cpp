@@ -391,13 +391,15 @@ namespace Vulkan
     }
   }
 
-  VkPipelineLayout Misc::CreatePipelineLayout(const VkDevice dev, const std::vector<VkDescriptorSetLayout> desc_layouts)
+  VkPipelineLayout Misc::CreatePipelineLayout(const VkDevice dev, const std::vector<VkDescriptorSetLayout> desc_layouts, const std::vector<VkPushConstantRange> push_constant_ranges)
   {
     VkPipelineLayout result = VK_NULL_HANDLE;
     VkPipelineLayoutCreateInfo pipeline_layout_create_info = {};
     pipeline_layout_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
     pipeline_layout_create_info.setLayoutCount = desc_layouts.empty() ? 0 : (uint32_t) desc_layouts.size();
     pipeline_layout_create_info.pSetLayouts = desc_layouts.empty() ? nullptr : desc_layouts.data();
+    pipeline_layout_create_info.pushConstantRangeCount = (uint32_t) push_constant_ranges.size();
+    pipeline_layout_create_info.pPushConstantRanges = push_constant_ranges.empty() ? nullptr : push_constant_ranges.data();
 
     auto er = vkCreatePipelineLayout(dev, &pipeline_layout_create_info, nullptr, &result);
     if (er != VK_SUCCESS)
@@ -34,8 +34,6 @@ namespace Vulkan
     static const std::vector<VkFormat> bit192;
     static const std::vector<VkFormat> bit256;
 
-    static std::vector<char> LoadShaderFromFile(const std::string file_name) noexcept;
-    static VkShaderModule CreateShaderModule(const VkDevice dev, const std::vector<char>& code) noexcept;
   public:
     Misc() = delete;
     Misc(const Misc &obj) = delete;
@@ -54,7 +52,9 @@ namespace Vulkan
     static size_t SizeOfFormat(const VkFormat format) noexcept;
 
     static VkShaderModule LoadPrecompiledShaderFromFile(const VkDevice dev, const std::string file_name) noexcept;
-    static VkPipelineLayout CreatePipelineLayout(const VkDevice dev, const std::vector<VkDescriptorSetLayout> desc_layouts);
+    static std::vector<char> LoadShaderFromFile(const std::string file_name) noexcept;
+    static VkShaderModule CreateShaderModule(const VkDevice dev, const std::vector<char>& code) noexcept;
+    static VkPipelineLayout CreatePipelineLayout(const VkDevice dev, const std::vector<VkDescriptorSetLayout> desc_layouts, const std::vector<VkPushConstantRange> push_constant_ranges = {});
     static std::string GetExecDirectory(const std::string argc_path) noexcept;
     static std::string GetFileExtention(const std::string file) noexcept;
     static VkDeviceSize Align(const VkDeviceSize value, const VkDeviceSize align) noexcept;
@@ -2,20 +2,42 @@
 
 namespace Vulkan
 {
+  void Pipelines::Take(Pipelines &obj) noexcept
+  {
+    pipelines = std::move(obj.pipelines);
+    builders = std::move(obj.builders);
+    sources = std::move(obj.sources);
+    chunk_storage = std::move(obj.chunk_storage);
+    handle_storage = std::move(obj.handle_storage);
+    retired = std::move(obj.retired);
+    for (size_t i = 0; i < max_chunks; ++i)
+      chunks[i].store(obj.chunks[i].exchange(nullptr, std::memory_order_acq_rel), std::memory_order_release);
+    handles_count.store(obj.handles_count.exchange(0, std::memory_order_acq_rel), std::memory_order_release);
+    obj.pipelines.clear();
+    obj.builders.clear();
+    obj.sources.clear();
+    obj.chunk_storage.clear();
+    obj.handle_storage.clear();
+    obj.retired.clear();
+  }
+
   Pipelines::Pipelines(Pipelines &&obj) noexcept
   {
+    obj.DisableHotReload();
     std::lock_guard lock(obj.pipelines_mutex);
 
-    pipelines = std::move(obj.pipelines);
+    Take(obj);
   }
 
   Pipelines &Pipelines::operator=(Pipelines &&obj) noexcept
   {
     if (&obj == this) return *this;
 
+    DisableHotReload();
+    obj.DisableHotReload();
     std::scoped_lock lock(pipelines_mutex, obj.pipelines_mutex);
 
-    pipelines = std::move(obj.pipelines);
+    Take(obj);
     return *this;
   }
 
@@ -23,9 +45,19 @@ namespace Vulkan
   {
     if (&obj == this) return;
 
+    DisableHotReload();
+    obj.DisableHotReload();
     std::scoped_lock lock(pipelines_mutex, obj.pipelines_mutex);
 
     pipelines.swap(obj.pipelines);
+    builders.swap(obj.builders);
+    sources.swap(obj.sources);
+    chunk_storage.swap(obj.chunk_storage);
+    handle_storage.swap(obj.handle_storage);
+    retired.swap(obj.retired);
+    for (size_t i = 0; i < max_chunks; ++i)
+      chunks[i].store(obj.chunks[i].exchange(chunks[i].load(std::memory_order_acquire), std::memory_order_acq_rel), std::memory_order_release);
+    handles_count.store(obj.handles_count.exchange(handles_count.load(std::memory_order_acquire), std::memory_order_acq_rel), std::memory_order_release);
   }
 
   void swap(Pipelines &lhs, Pipelines &rhs) noexcept
@@ -35,76 +67,354 @@ namespace Vulkan
     lhs.swap(rhs);
   }
 
+  PipelineHandle Pipelines::MakeHandle(const Pipeline &obj)
+  {
+    PipelineHandle handle = std::visit([] (auto &&p) -> PipelineHandle { return { p.GetPipeline(), p.GetLayout(), VK_PIPELINE_BIND_POINT_GRAPHICS, {} }; }, obj);
+    if (std::holds_alternative<ComputePipeline>(obj))
+    {
+      handle.bind_point = VK_PIPELINE_BIND_POINT_COMPUTE;
+      handle.workgroup_size = std::get<ComputePipeline>(obj).GetWorkgroupSize();
+    }
+
+    return handle;
+  }
+
+  std::filesystem::path Pipelines::NormalizePath(const std::filesystem::path &path)
+  {
+    std::error_code ec;
+    auto result = std::filesystem::absolute(path, ec);
+    return ec ? path.lexically_normal() : result.lexically_normal();
+  }
+
+  VkResult Pipelines::Publish(Pipeline &&obj, std::function<Pipeline()> builder, std::vector<std::filesystem::path> files)
+  {
+    size_t index = handles_count.load(std::memory_order_relaxed);
+    if (index >= chunk_size * max_chunks)
+    {
+      Logger::EchoError("Too many pipelines", __func__);
+      return VK_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    auto chunk = chunks[index / chunk_size].load(std::memory_order_relaxed);
+    if (chunk == nullptr)
+    {
+      chunk_storage.push_back(std::unique_ptr<HandleSlot[]>(new HandleSlot[chunk_size]()));
+      chunk = chunk_storage.back().get();
+      chunks[index / chunk_size].store(chunk, std::memory_order_release);
+    }
+
+    files.erase(std::remove_if(files.begin(), files.end(), [] (const auto &f) { return f.empty(); }), files.end());
+    for (auto &f : files)
+    {
+      f = NormalizePath(f);
+      if (watching.load())
+        AddWatch(f);
+    }
+
+    handle_storage.push_back(std::make_unique<PipelineHandle>(MakeHandle(obj)));
+    auto handle = handle_storage.back().get();
+    pipelines.emplace_back(std::move(obj));
+    builders.push_back(std::move(builder));
+    sources.push_back(std::move(files));
+    chunk[index % chunk_size].store(handle, std::memory_order_release);
+    handles_count.store(index + 1, std::memory_order_release);
+
+    return handle->pipeline != VK_NULL_HANDLE ? VK_SUCCESS : VK_INCOMPLETE;
+  }
+
   VkResult Pipelines::AddPipeline(const std::shared_ptr<Device> dev, const ComputePipelineConfig &params)
   {
+    ComputePipeline pipeline(dev, params);
+    std::vector<std::filesystem::path> files;
+    if (params.shader_info.source.empty() && params.shader_info.embedded.empty())
+      files.push_back(params.shader_info.file_path);
+
     std::lock_guard lock(pipelines_mutex);
+    return Publish(std::move(pipeline), [dev, params] () -> Pipeline { return ComputePipeline(dev, params); }, files);
+  }
 
-    pipelines.emplace_back(ComputePipeline(dev, params));
+  VkResult Pipelines::AddPipelines(const std::shared_ptr<Device> dev, const std::vector<ComputePipelineConfig> &params, std::vector<size_t> &indices)
+  {
+    indices.clear();
+    if (params.empty())
+      return VK_SUCCESS;
 
-    return std::visit([](auto&& obj) -> VkResult
+    std::vector<std::optional<ComputePipeline>> built(params.size());
+    std::atomic<size_t> next = 0;
+    size_t workers_count = std::min<size_t>(params.size(), std::max(std::thread::hardware_concurrency(), 1u));
+    std::vector<std::future<void>> workers;
+    workers.reserve(workers_count);
+
+    for (size_t w = 0; w < workers_count; ++w)
+    {
+      workers.push_back(std::async(std::launch::async, [&] ()
+        {
+          for (size_t i = next++; i < params.size(); i = next++)
+            built[i].emplace(dev, params[i]);
+        }));
+    }
+
+    for (auto &w : workers)
+      w.get();
+
+    std::lock_guard lock(pipelines_mutex);
+
+    VkResult ret = VK_SUCCESS;
+    for (size_t i = 0; i < built.size(); ++i)
+    {
+      std::vector<std::filesystem::path> files;
+      if (params[i].shader_info.source.empty() && params[i].shader_info.embedded.empty())
+        files.push_back(params[i].shader_info.file_path);
+
+      indices.push_back(handles_count.load(std::memory_order_relaxed));
+      auto er = Publish(std::move(built[i].value()), [dev, config = params[i]] () -> Pipeline { return ComputePipeline(dev, config); }, files);
+      if (er == VK_ERROR_OUT_OF_HOST_MEMORY)
       {
-        return obj.GetPipeline() != VK_NULL_HANDLE ? VK_SUCCESS : VK_INCOMPLETE;
-      }, pipelines[pipelines.size() - 1]);
+        indices.pop_back();
+        return er;
+      }
+
+      if (er != VK_SUCCESS)
+        ret = er;
+    }
 
+    return ret;
   }
 
   VkResult Pipelines::AddPipeline(const std::shared_ptr<Device> dev, const std::shared_ptr<SwapChain> swapchain, const std::shared_ptr<RenderPass> render_pass, const GraphicPipelineConfig &params)
   {
+    GraphicPipeline pipeline(dev, swapchain, render_pass, params);
+    std::vector<std::filesystem::path> files;
+    for (auto &s : params.shader_infos)
+    {
+      if (s.second.embedded.empty())
+        files.push_back(s.second.file_path);
+    }
+
     std::lock_guard lock(pipelines_mutex);
+    return Publish(std::move(pipeline), [dev, swapchain, render_pass, params] () -> Pipeline { return GraphicPipeline(dev, swapchain, render_pass, params); }, files);
+  }
 
-    pipelines.emplace_back(GraphicPipeline(dev, swapchain, render_pass, params));
+  VkResult Pipelines::AddPipeline(ComputePipeline &&obj)
+  {
+    if (obj.GetPipeline() == VK_NULL_HANDLE)
+      return VK_INCOMPLETE;
 
-    return std::visit([](auto&& obj) -> VkResult
-      {
-        return obj.GetPipeline() != VK_NULL_HANDLE ? VK_SUCCESS : VK_INCOMPLETE;
-      }, pipelines[pipelines.size() - 1]);
+    std::lock_guard lock(pipelines_mutex);
+    return Publish(std::move(obj));
   }
 
-  VkResult Pipelines::AddPipeline(ComputePipeline &&obj)
+  VkResult Pipelines::AddPipeline(GraphicPipeline &&obj)
   {
+    if (obj.GetPipeline() == VK_NULL_HANDLE)
+      return VK_INCOMPLETE;
+
     std::lock_guard lock(pipelines_mutex);
-    if (obj.GetPipeline() != VK_NULL_HANDLE)
+    return Publish(std::move(obj));
+  }
+
+  PipelineHandle Pipelines::GetHandle(const size_t index) const noexcept
+  {
+    if (index >= handles_count.load(std::memory_order_acquire))
     {
-      pipelines.emplace_back(std::move(obj));
-      return VK_SUCCESS;
+      Logger::EchoError("Index is out off range", __func__);
+      return {};
     }
 
-    return VK_INCOMPLETE;
+    auto handle = chunks[index / chunk_size].load(std::memory_order_acquire)[index % chunk_size].load(std::memory_order_acquire);
+    return handle != nullptr ? *handle : PipelineHandle();
   }
 
-  VkResult Pipelines::AddPipeline(GraphicPipeline &&obj)
+  void Pipelines::AddWatch(const std::filesystem::path &file)
   {
-    std::lock_guard lock(pipelines_mutex);
-    if (obj.GetPipeline() != VK_NULL_HANDLE)
+#ifdef __linux__
+    auto dir = file.parent_path();
+    for (auto &d : watch_dirs)
     {
-      pipelines.emplace_back(std::move(obj));
+      if (d.second == dir)
+        return;
+    }
+
+    int wd = inotify_add_watch(watch_fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (wd < 0)
+    {
+      Logger::EchoWarning("Can't watch " + dir.string(), __func__);
+      return;
+    }
+
+    watch_dirs[wd] = dir;
+#endif
+  }
+
+  VkResult Pipelines::EnableHotReload()
+  {
+#ifdef __linux__
+    std::lock_guard lock(pipelines_mutex);
+    if (watching.load())
       return VK_SUCCESS;
+
+    watch_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (watch_fd < 0)
+    {
+      Logger::EchoError("Can't initialize inotify", __func__);
+      return VK_ERROR_INITIALIZATION_FAILED;
+    }
+
+    for (auto &files : sources)
+    {
+      for (auto &f : files)
+        AddWatch(f);
     }
 
-    return VK_INCOMPLETE;
+    watching.store(true);
+    watcher = std::thread(&Pipelines::WatchLoop, this);
+
+    return VK_SUCCESS;
+#else
+    Logger::EchoWarning("Hot reload is supported only on Linux", __func__);
+    return VK_ERROR_FEATURE_NOT_PRESENT;
+#endif
   }
 
-  VkPipelineLayout Pipelines::GetLayout(const size_t index)
+  void Pipelines::DisableHotReload() noexcept
   {
+    watching.store(false);
+    if (watcher.joinable())
+      watcher.join();
+
+#ifdef __linux__
     std::lock_guard lock(pipelines_mutex);
-    if (index >= pipelines.size())
+    if (watch_fd >= 0)
     {
-      Logger::EchoError("Index is out off range", __func__);
-      return VK_NULL_HANDLE;
+      close(watch_fd);
+      watch_fd = -1;
+    }
+    watch_dirs.clear();
+#endif
+  }
+
+  void Pipelines::WatchLoop()
+  {
+#ifdef __linux__
+    std::vector<char> buffer(64 * (sizeof(inotify_event) + NAME_MAX + 1));
+
+    while (watching.load())
+    {
+      pollfd pfd = { watch_fd, POLLIN, 0 };
+      if (poll(&pfd, 1, 100) <= 0)
+        continue;
+
+      std::set<std::filesystem::path> changed;
+      for (auto len = read(watch_fd, buffer.data(), buffer.size()); len > 0; len = read(watch_fd, buffer.data(), buffer.size()))
+      {
+        std::lock_guard lock(pipelines_mutex);
+        for (ssize_t i = 0; i < len;)
+        {
+          auto event = (const inotify_event *) (buffer.data() + i);
+          auto dir = watch_dirs.find(event->wd);
+          if (event->len > 0 && dir != watch_dirs.end())
+            changed.insert(dir->second / event->name);
+          i += sizeof(inotify_event) + event->len;
+        }
+      }
+
+      if (!changed.empty())
+        Reload(changed);
+    }
+#endif
+  }
+
+  void Pipelines::Reload(const std::set<std::filesystem::path> &changed)
+  {
+    std::vector<std::pair<size_t, std::function<Pipeline()>>> targets;
+    {
+      std::lock_guard lock(pipelines_mutex);
+      for (size_t i = 0; i < sources.size(); ++i)
+      {
+        if (!builders[i])
+          continue;
+
+        if (std::any_of(sources[i].begin(), sources[i].end(), [&changed] (const auto &f) { return changed.count(f) > 0; }))
+          targets.push_back({ i, builders[i] });
+      }
     }
-    
-    return std::visit([] (auto &&obj) -> VkPipelineLayout { return obj.GetLayout(); }, pipelines[index]);
+
+    for (auto &t : targets)
+    {
+      auto pipeline = t.second();
+      if (MakeHandle(pipeline).pipeline == VK_NULL_HANDLE)
+      {
+        Logger::EchoError("Can't rebuild pipeline " + std::to_string(t.first), __func__);
+        continue;
+      }
+
+      std::lock_guard lock(reload_mutex);
+      pending_reloads.emplace_back(t.first, std::move(pipeline));
+    }
+  }
+
+  size_t Pipelines::GetPendingReloadsCount()
+  {
+    std::lock_guard lock(reload_mutex);
+    return pending_reloads.size();
+  }
+
+  bool Pipelines::IsRetiredComplete(const RetiredPipeline &obj)
+  {
+    auto dev = std::visit([] (auto &&p) { return p.GetDevice(); }, obj.pipeline);
+    if (dev.get() == nullptr)
+      return true;
+
+    if (obj.fence != VK_NULL_HANDLE)
+      return vkGetFenceStatus(dev->GetDevice(), obj.fence) == VK_SUCCESS;
+
+    if (obj.timeline != VK_NULL_HANDLE)
+    {
+      uint64_t value = 0;
+      return vkGetSemaphoreCounterValue(dev->GetDevice(), obj.timeline, &value) == VK_SUCCESS && value >= obj.value;
+    }
+
+    return true;
   }
 
-  VkPipeline Pipelines::GetPipeline(const size_t index)
+  size_t Pipelines::CollectRetired()
   {
     std::lock_guard lock(pipelines_mutex);
-    if (index >= pipelines.size())
+    auto it = std::stable_partition(retired.begin(), retired.end(), [] (const auto &r) { return !IsRetiredComplete(r); });
+    size_t count = std::distance(it, retired.end());
+    retired.erase(it, retired.end());
+
+    return count;
+  }
+
+  size_t Pipelines::GetRetiredCount()
+  {
+    std::lock_guard lock(pipelines_mutex);
+    return retired.size();
+  }
+
+  size_t Pipelines::Commit(const VkFence fence, const VkSemaphore timeline, const uint64_t value)
+  {
+    CollectRetired();
+
+    std::vector<std::pair<size_t, Pipeline>> ready;
     {
-      Logger::EchoError("Index is out off range", __func__);
-      return VK_NULL_HANDLE;
+      std::lock_guard lock(reload_mutex);
+      ready.swap(pending_reloads);
+    }
+
+    std::lock_guard lock(pipelines_mutex);
+    for (auto &r : ready)
+    {
+      auto &slot = chunks[r.first / chunk_size].load(std::memory_order_acquire)[r.first % chunk_size];
+      // Old handles stay in handle_storage: a lock-free GetHandle may still be copying one
+      handle_storage.push_back(std::make_unique<PipelineHandle>(MakeHandle(r.second)));
+      slot.store(handle_storage.back().get(), std::memory_order_release);
+
+      retired.push_back({ std::move(pipelines[r.first]), fence, timeline, value });
+      pipelines[r.first] = std::move(r.second);
     }
 
-    return std::visit([] (auto &&obj) -> VkPipeline { return obj.GetPipeline(); }, pipelines[index]);
+    return ready.size();
   }
 }
\ No newline at end of file
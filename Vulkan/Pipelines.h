@@ -13,6 +13,21 @@
 #include <mutex>
 #include <variant>
 #include <filesystem>
+#include <future>
+#include <thread>
+#include <atomic>
+#include <optional>
+#include <array>
+#include <functional>
+#include <set>
+#include <map>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#include <climits>
+#endif
 
 namespace Vulkan
 {
@@ -21,21 +36,68 @@ namespace Vulkan
   class Pipelines
   {
   private:
+    using HandleSlot = std::atomic<const PipelineHandle *>;
+    struct RetiredPipeline
+    {
+      Pipeline pipeline;
+      VkFence fence = VK_NULL_HANDLE;
+      VkSemaphore timeline = VK_NULL_HANDLE;
+      uint64_t value = 0;
+    };
+    static constexpr size_t chunk_size = 64;
+    static constexpr size_t max_chunks = 1024;
     std::vector<Pipeline> pipelines;
+    std::vector<std::function<Pipeline()>> builders;
+    std::vector<std::vector<std::filesystem::path>> sources;
+    std::vector<std::unique_ptr<HandleSlot[]>> chunk_storage;
+    std::vector<std::unique_ptr<PipelineHandle>> handle_storage;
+    std::array<std::atomic<HandleSlot *>, max_chunks> chunks = {};
+    std::atomic<size_t> handles_count = 0;
     std::mutex pipelines_mutex;
+
+    std::mutex reload_mutex;
+    std::vector<std::pair<size_t, Pipeline>> pending_reloads;
+    std::vector<RetiredPipeline> retired;
+    std::map<int, std::filesystem::path> watch_dirs;
+    std::atomic<bool> watching = false;
+    std::thread watcher;
+    int watch_fd = -1;
+
+    static PipelineHandle MakeHandle(const Pipeline &obj);
+    static std::filesystem::path NormalizePath(const std::filesystem::path &path);
+    VkResult Publish(Pipeline &&obj, std::function<Pipeline()> builder = {}, std::vector<std::filesystem::path> files = {});
+    void Take(Pipelines &obj) noexcept;
+    void AddWatch(const std::filesystem::path &file);
+    void WatchLoop();
+    void Reload(const std::set<std::filesystem::path> &changed);
+    static bool IsRetiredComplete(const RetiredPipeline &obj);
+    size_t Commit(const VkFence fence, const VkSemaphore timeline, const uint64_t value);
   public:
     Pipelines() = default;
     Pipelines(const Pipelines &obj) = delete;
     Pipelines(Pipelines &&obj) noexcept;
     Pipelines &operator=(const Pipelines &obj) = delete;
     Pipelines &operator=(Pipelines &&obj) noexcept;
+    ~Pipelines() noexcept { DisableHotReload(); }
     void swap(Pipelines &obj) noexcept;
     VkResult AddPipeline(const std::shared_ptr<Device> dev, const ComputePipelineConfig &params);
+    VkResult AddPipelines(const std::shared_ptr<Device> dev, const std::vector<ComputePipelineConfig> &params, std::vector<size_t> &indices);
     VkResult AddPipeline(const std::shared_ptr<Device> dev, const std::shared_ptr<SwapChain> swapchain, const std::shared_ptr<RenderPass> render_pass, const GraphicPipelineConfig &params);
     VkResult AddPipeline(ComputePipeline &&obj);
     VkResult AddPipeline(GraphicPipeline &&obj);
-    VkPipelineLayout GetLayout(const size_t index);
-    VkPipeline GetPipeline(const size_t index);
+    PipelineHandle GetHandle(const size_t index) const noexcept;
+    size_t GetPipelinesCount() const noexcept { return handles_count.load(std::memory_order_acquire); }
+    VkPipelineLayout GetLayout(const size_t index) const noexcept { return GetHandle(index).layout; }
+    VkPipeline GetPipeline(const size_t index) const noexcept { return GetHandle(index).pipeline; }
+    WorkgroupSize GetWorkgroupSize(const size_t index) const noexcept { return GetHandle(index).workgroup_size; }
+    VkResult EnableHotReload();
+    void DisableHotReload() noexcept;
+    bool IsHotReloadEnabled() const noexcept { return watching.load(); }
+    size_t GetPendingReloadsCount();
+    size_t CommitReloads(const VkFence fence) { return Commit(fence, VK_NULL_HANDLE, 0); }
+    size_t CommitReloads(const VkSemaphore timeline, const uint64_t value) { return Commit(VK_NULL_HANDLE, timeline, value); }
+    size_t CollectRetired();
+    size_t GetRetiredCount();
   };
 
   void swap(Pipelines &lhs, Pipelines &rhs) noexcept;
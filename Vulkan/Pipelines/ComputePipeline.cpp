@@ -7,7 +7,8 @@ namespace Vulkan
     Logger::EchoDebug("", __func__);
     if (shader.shader != VK_NULL_HANDLE)
     {
-      vkDestroyShaderModule(device->GetDevice(), shader.shader, nullptr);
+      device->ReleaseShaderModule(shader.shader);
+      shader.shader = VK_NULL_HANDLE;
     }
 
     if (pipeline_layout != VK_NULL_HANDLE)
@@ -31,7 +32,7 @@ namespace Vulkan
       return;
     }
 
-    if (!std::filesystem::exists(params.shader_info.file_path))
+    if (params.shader_info.source.empty() && params.shader_info.embedded.empty() && !std::filesystem::exists(params.shader_info.file_path))
     {
       Logger::EchoError("Shader file path is not valid", __func__);
       return;
@@ -46,8 +47,38 @@ namespace Vulkan
     device = dev;
     shader.entry = params.shader_info.entry;
     desc_layouts = params.desc_layouts;
-    shader.shader = Misc::LoadPrecompiledShaderFromFile(device->GetDevice(), params.shader_info.file_path);
-    pipeline_layout = Misc::CreatePipelineLayout(device->GetDevice(), desc_layouts);
+    std::vector<char> code;
+    if (!params.shader_info.source.empty())
+      code = ShaderCompiler::Compile(params.shader_info.source, params.shader_info.type, params.shader_info.defines, device->GetShaderCacheDirectory());
+    else if (!params.shader_info.embedded.empty())
+      code = EmbeddedShaders::Get(params.shader_info.embedded);
+    else
+      code = device->LoadShaderCode(params.shader_info.file_path);
+
+    if (code.empty())
+    {
+      Logger::EchoError("No shader code", __func__);
+      return;
+    }
+
+    SpecializationConstants specialization = params.specialization;
+    if (!params.autotune_name.empty())
+    {
+      if (auto tuned = device->GetTunedWorkgroupSize(params.autotune_name); tuned.has_value())
+      {
+        const uint32_t sizes[3] = { tuned->x, tuned->y, tuned->z };
+        for (size_t d = 0; d < 3; ++d)
+        {
+          if (params.autotune_ids[d].has_value())
+            specialization.Set(params.autotune_ids[d].value(), sizes[d]);
+        }
+      }
+    }
+
+    reflection = ShaderReflection(code, shader.entry);
+    workgroup_size = reflection.GetWorkgroupSize(specialization);
+    shader.shader = device->AcquireShaderModule(code);
+    pipeline_layout = Misc::CreatePipelineLayout(device->GetDevice(), desc_layouts, reflection.GetPushConstantRanges());
 
     VkPipelineShaderStageCreateInfo shader_stage_create_info = {};
     shader_stage_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -55,14 +86,19 @@ namespace Vulkan
     shader_stage_create_info.module = shader.shader;
     shader_stage_create_info.pName = shader.entry.c_str();
 
+    VkSpecializationInfo specialization_info = specialization.GetInfo();
+    if (!specialization.Empty())
+      shader_stage_create_info.pSpecializationInfo = &specialization_info;
+
     VkComputePipelineCreateInfo pipeline_create_info = {};
     pipeline_create_info.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
     pipeline_create_info.stage = shader_stage_create_info;
     pipeline_create_info.layout = pipeline_layout;
     pipeline_create_info.basePipelineHandle = params.base_pipeline;
     pipeline_create_info.flags = params.base_pipeline != VK_NULL_HANDLE ? VK_PIPELINE_CREATE_DERIVATIVE_BIT : VK_PIPELINE_CREATE_ALLOW_DERIVATIVES_BIT;
+    pipeline_create_info.flags |= VK_PIPELINE_CREATE_DISPATCH_BASE_BIT;
 
-    auto er = vkCreateComputePipelines(device->GetDevice(), VK_NULL_HANDLE, 1, &pipeline_create_info, nullptr, &pipeline);
+    auto er = vkCreateComputePipelines(device->GetDevice(), device->GetPipelineCache(), 1, &pipeline_create_info, nullptr, &pipeline);
       
     if (er != VK_SUCCESS)
     {
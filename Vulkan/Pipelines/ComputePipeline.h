@@ -5,10 +5,14 @@
 #include "../Logger.h"
 #include "../Device.h"
 #include "Types.h"
+#include "ShaderReflection.h"
+#include "ShaderCompiler.h"
+#include "EmbeddedShaders.h"
 
 #include <vulkan/vulkan.h>
 #include <memory>
 #include <algorithm>
+#include <array>
 
 namespace Vulkan
 {
@@ -17,9 +21,13 @@ namespace Vulkan
   private:
     friend class Pipelines;
     friend class ComputePipeline_impl;
+    friend class Autotuner;
     std::vector<VkDescriptorSetLayout> desc_layouts;
     VkPipeline base_pipeline = VK_NULL_HANDLE;
     ShaderInfo shader_info;
+    SpecializationConstants specialization;
+    std::string autotune_name;
+    std::array<std::optional<uint32_t>, 3> autotune_ids;
   public:
     ComputePipelineConfig() = default;
     ~ComputePipelineConfig() noexcept = default;
@@ -34,7 +42,24 @@ namespace Vulkan
       if (std::filesystem::exists(file_path)) shader_info = {entry, file_path, ShaderType::Compute}; 
       return *this; 
     }
+    auto &SetEmbeddedShader(const std::string name, const std::string entry = "main")
+    {
+      if (EmbeddedShaders::Contains(name)) shader_info = {entry, {}, ShaderType::Compute, {}, {}, name};
+      return *this;
+    }
+    auto &SetShaderSource(const std::string source, const std::map<std::string, std::string> defines = {})
+    {
+      if (!source.empty()) shader_info = {"main", {}, ShaderType::Compute, source, defines};
+      return *this;
+    }
     auto &SetBasePipeline(const VkPipeline pipeline) noexcept { base_pipeline = pipeline; return *this; }
+    template <typename T> auto &SetSpecializationConstant(const uint32_t id, const T value) { specialization.Set(id, value); return *this; }
+    auto &SetAutotune(const std::string name, const uint32_t x_id, const std::optional<uint32_t> y_id = {}, const std::optional<uint32_t> z_id = {})
+    {
+      autotune_name = name;
+      autotune_ids = { x_id, y_id, z_id };
+      return *this;
+    }
   };
 
   class ComputePipeline_impl
@@ -53,9 +78,13 @@ namespace Vulkan
     VkPipelineLayout pipeline_layout = VK_NULL_HANDLE;
     std::vector<VkDescriptorSetLayout> desc_layouts;
     Shader shader;
+    WorkgroupSize workgroup_size;
+    ShaderReflection reflection;
 
     ComputePipeline_impl(const std::shared_ptr<Device> dev, const ComputePipelineConfig &params);
     VkPipeline GetPipeline() const noexcept { return pipeline; }
+    WorkgroupSize GetWorkgroupSize() const noexcept { return workgroup_size; }
+    const ShaderReflection &GetReflection() const noexcept { return reflection; }
     VkPipelineLayout GetLayout() const noexcept { return pipeline_layout; }
     std::shared_ptr<Device> GetDevice() const noexcept { return device; }
   };
@@ -76,6 +105,8 @@ namespace Vulkan
 
     VkPipeline GetPipeline() const noexcept { if (impl.get()) return impl->GetPipeline(); return VK_NULL_HANDLE; }
     VkPipelineLayout GetLayout() const noexcept { if (impl.get()) return impl->GetLayout(); return VK_NULL_HANDLE; }
+    WorkgroupSize GetWorkgroupSize() const noexcept { if (impl.get()) return impl->GetWorkgroupSize(); return {}; }
+    ShaderReflection GetReflection() const { if (impl.get()) return impl->GetReflection(); return {}; }
     bool IsValid() const noexcept { return impl.get() && impl->pipeline != VK_NULL_HANDLE; }
     std::shared_ptr<Device> GetDevice() const noexcept { if (impl.get()) return impl->GetDevice(); return nullptr; }
     ~ComputePipeline() noexcept = default;
@@ -0,0 +1,37 @@
+#include "EmbeddedShaders.h"
+
+namespace Vulkan
+{
+  const EmbeddedShaders::Entry *EmbeddedShaders::Find(const std::string &name) noexcept
+  {
+    for (size_t i = 0; i < entries_count; ++i)
+    {
+      if (name == entries[i].name)
+        return &entries[i];
+    }
+
+    return nullptr;
+  }
+
+  std::vector<char> EmbeddedShaders::Get(const std::string &name)
+  {
+    auto entry = Find(name);
+    if (entry == nullptr)
+    {
+      Logger::EchoError("No embedded shader " + name, __func__);
+      return {};
+    }
+
+    return std::vector<char>((const char *) entry->data, (const char *) entry->data + entry->size);
+  }
+
+  std::vector<std::string> EmbeddedShaders::GetNames()
+  {
+    std::vector<std::string> result;
+    result.reserve(entries_count);
+    for (size_t i = 0; i < entries_count; ++i)
+      result.push_back(entries[i].name);
+
+    return result;
+  }
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+#ifndef __VULKAN_EMBEDDED_SHADERS_H
+#define __VULKAN_EMBEDDED_SHADERS_H
+
+#include "../Logger.h"
+
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstddef>
+
+namespace Vulkan
+{
+  class EmbeddedShaders
+  {
+  private:
+    struct Entry
+    {
+      const char *name;
+      const unsigned char *data;
+      size_t size;
+    };
+
+    static const Entry entries[];
+    static const size_t entries_count;
+    static const Entry *Find(const std::string &name) noexcept;
+  public:
+    EmbeddedShaders() = delete;
+    static bool Contains(const std::string &name) noexcept { return Find(name) != nullptr; }
+    static std::vector<char> Get(const std::string &name);
+    static std::vector<std::string> GetNames();
+  };
+}
+
+#endif
\ No newline at end of file
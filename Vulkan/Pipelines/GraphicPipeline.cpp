@@ -8,7 +8,7 @@ namespace Vulkan
     for (auto &obj : shaders)
     { 
       if (obj.shader != VK_NULL_HANDLE) 
-        vkDestroyShaderModule(device->GetDevice(), obj.shader, nullptr);
+        device->ReleaseShaderModule(obj.shader);
     }
 
     if (pipeline_layout != VK_NULL_HANDLE)
@@ -81,8 +81,8 @@ namespace Vulkan
     SetupDepthStencil();
     SetupTessellation();
 
-    BuildLayout();
     BuildShaders();
+    BuildLayout();
 
     VkGraphicsPipelineCreateInfo pipeline_create_info = {};
     pipeline_create_info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
@@ -115,7 +115,7 @@ namespace Vulkan
       pipeline = VK_NULL_HANDLE;
     }
 
-    auto er = vkCreateGraphicsPipelines(device->GetDevice(), VK_NULL_HANDLE, 1, &pipeline_create_info, nullptr, &pipeline);
+    auto er = vkCreateGraphicsPipelines(device->GetDevice(), device->GetPipelineCache(), 1, &pipeline_create_info, nullptr, &pipeline);
 
     if (er != VK_SUCCESS)
     {
@@ -133,11 +133,15 @@ namespace Vulkan
       for (auto &obj : shaders)
       { 
         if (obj.shader != VK_NULL_HANDLE) 
-          vkDestroyShaderModule(device->GetDevice(), obj.shader, nullptr);
+          device->ReleaseShaderModule(obj.shader);
       }
       
+      shaders.clear();
+      stages_config.stage_infos.clear();
       shaders.reserve(init_config.shader_infos.size());
       stages_config.stage_infos.reserve(init_config.shader_infos.size());
+      stages_config.specialization_info = init_config.specialization.GetInfo();
+      push_constant_ranges.clear();
 
       for (auto &obj : init_config.shader_infos)
       {
@@ -145,10 +149,13 @@ namespace Vulkan
         stages_config.stage_infos.push_back({});
         auto i = shaders.size() - 1;
         shaders[i].entry = obj.second.entry;
-        shaders[i].shader = Misc::LoadPrecompiledShaderFromFile(device->GetDevice(), obj.second.file_path.string());
+        auto code = obj.second.embedded.empty() ? device->LoadShaderCode(obj.second.file_path) : EmbeddedShaders::Get(obj.second.embedded);
+        auto ranges = ShaderReflection(code, shaders[i].entry).GetPushConstantRanges();
+        std::copy(ranges.begin(), ranges.end(), std::back_inserter(push_constant_ranges));
+        shaders[i].shader = device->AcquireShaderModule(code);
         stages_config.stage_infos[i].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
         stages_config.stage_infos[i].pNext = nullptr;
-        stages_config.stage_infos[i].pSpecializationInfo = nullptr;
+        stages_config.stage_infos[i].pSpecializationInfo = init_config.specialization.Empty() ? nullptr : &stages_config.specialization_info;
         stages_config.stage_infos[i].module = shaders[i].shader;
         stages_config.stage_infos[i].stage = (VkShaderStageFlagBits) obj.second.type;
         stages_config.stage_infos[i].pName = shaders[i].entry.c_str();
@@ -156,6 +163,7 @@ namespace Vulkan
       }
       
       build_shaders = false;
+      build_layout = true;
     }
   }
 
@@ -166,7 +174,7 @@ namespace Vulkan
       if (pipeline_layout != VK_NULL_HANDLE)
         vkDestroyPipelineLayout(device->GetDevice(), pipeline_layout, nullptr);
 
-      pipeline_layout = Misc::CreatePipelineLayout(device->GetDevice(), init_config.desc_layouts);
+      pipeline_layout = Misc::CreatePipelineLayout(device->GetDevice(), init_config.desc_layouts, push_constant_ranges);
       build_layout = false;
     }
   }
@@ -7,6 +7,8 @@
 #include "../SwapChain.h"
 #include "../RenderPass.h"
 #include "Types.h"
+#include "ShaderReflection.h"
+#include "EmbeddedShaders.h"
 
 #include <vulkan/vulkan.h>
 #include <memory>
@@ -32,6 +34,7 @@ namespace Vulkan
     std::vector<VkRect2D> scissors;
     std::vector<VkDynamicState> dynamic_states;
     std::vector<VkPipelineShaderStageCreateInfo> stage_infos;
+    VkSpecializationInfo specialization_info = {};
   };
 
   class GraphicPipelineConfig
@@ -51,6 +54,7 @@ namespace Vulkan
     std::set<VkDynamicState> dynamic_states;
     VkPipeline base_pipeline = VK_NULL_HANDLE;
     std::map<ShaderType, ShaderInfo> shader_infos;
+    SpecializationConstants specialization;
     VkPolygonMode polygon_mode = VK_POLYGON_MODE_FILL;
     VkPrimitiveTopology primitive_topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
     VkFrontFace front_face = VK_FRONT_FACE_COUNTER_CLOCKWISE;
@@ -78,6 +82,12 @@ namespace Vulkan
       else Logger::EchoWarning("Shader path is not exists", __func__); 
       return *this;
     }
+    auto &AddEmbeddedShader(const ShaderType type, const std::string name, const std::string entry = "main")
+    {
+      if (EmbeddedShaders::Contains(name)) shader_infos[type] = {entry, {}, type, {}, {}, name};
+      else Logger::EchoWarning("No embedded shader " + name, __func__); 
+      return *this;
+    }
     auto &SetPolygonMode(const VkPolygonMode mode) noexcept { polygon_mode = mode; return *this; }
     auto &SetPrimitiveTopology(const VkPrimitiveTopology topology) noexcept { primitive_topology = topology; return *this; }
     auto &SetFace(const VkFrontFace face) noexcept { front_face = face; return *this; }
@@ -96,6 +106,7 @@ namespace Vulkan
     }
     auto &AddDynamicState(const VkDynamicState state) { dynamic_states.insert(state); return *this; }
     auto &SetSubpass(const uint32_t index) noexcept { subpass = index; return *this; }
+    template <typename T> auto &SetSpecializationConstant(const uint32_t id, const T value) { specialization.Set(id, value); return *this; }
   };
 
   class GraphicPipeline_impl
@@ -115,6 +126,7 @@ namespace Vulkan
     VkPipeline pipeline = VK_NULL_HANDLE;
     VkPipelineLayout pipeline_layout = VK_NULL_HANDLE;
     std::vector<Shader> shaders;
+    std::vector<VkPushConstantRange> push_constant_ranges;
     GraphicPipelineStageStructs stages_config = {};
     GraphicPipelineConfig init_config;
     bool build_shaders = true;
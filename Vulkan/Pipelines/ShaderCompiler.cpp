@@ -0,0 +1,231 @@
+#include "ShaderCompiler.h"
+
+namespace Vulkan
+{
+  std::string ShaderCompiler::GetStageName(const ShaderType type) noexcept
+  {
+    switch ((VkShaderStageFlagBits) type)
+    {
+      case VK_SHADER_STAGE_VERTEX_BIT: return "vert";
+      case VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT: return "tesc";
+      case VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT: return "tese";
+      case VK_SHADER_STAGE_GEOMETRY_BIT: return "geom";
+      case VK_SHADER_STAGE_FRAGMENT_BIT: return "frag";
+      case VK_SHADER_STAGE_COMPUTE_BIT: return "comp";
+      default: return "";
+    }
+  }
+
+  std::string ShaderCompiler::GetCacheKey(const std::string &source, const ShaderType type, const std::map<std::string, std::string> &defines)
+  {
+    std::string key = std::string(backend) + "\n" + target_env + "\n" + GetStageName(type) + "\n";
+    for (auto &d : defines)
+      key += std::to_string(d.first.size()) + ":" + d.first + "=" + std::to_string(d.second.size()) + ":" + d.second + "\n";
+    key += source;
+    return key;
+  }
+
+  std::string ShaderCompiler::GetKeyHash(const std::string &key)
+  {
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char ch : key)
+    {
+      hash ^= ch;
+      hash *= 1099511628211ull;
+    }
+
+    std::stringstream ss;
+    ss << std::hex << std::setfill('0') << std::setw(16) << hash;
+    return ss.str();
+  }
+
+  std::string ShaderCompiler::ReadTextFile(const std::filesystem::path &file_path)
+  {
+    std::ifstream f(file_path, std::ios::binary);
+    if (!f.is_open())
+      return {};
+
+    return std::string(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+  }
+
+  std::filesystem::path ShaderCompiler::GetDefaultCacheDirectory()
+  {
+    std::error_code ec;
+    auto dir = std::filesystem::temp_directory_path(ec);
+    return ec ? std::filesystem::path("spirv_cache") : dir / "spirv_cache";
+  }
+
+  bool ShaderCompiler::WriteFile(const std::filesystem::path &file_path, const char *data, const size_t size)
+  {
+    std::stringstream tid;
+    tid << std::this_thread::get_id();
+    auto tmp_path = file_path;
+    tmp_path += ".tmp" + tid.str();
+
+    {
+      std::ofstream f(tmp_path, std::ios::binary | std::ios::trunc);
+      if (!f.is_open())
+        return false;
+      f.write(data, size);
+      if (!f.good())
+        return false;
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmp_path, file_path, ec);
+    if (ec)
+    {
+      std::filesystem::remove(tmp_path, ec);
+      return false;
+    }
+
+    return true;
+  }
+
+  std::vector<char> ShaderCompiler::Compile(const std::string &source, const ShaderType type, const std::map<std::string, std::string> &defines, std::filesystem::path cache_dir)
+  {
+    if (source.empty())
+    {
+      Logger::EchoError("Shader source is empty", __func__);
+      return {};
+    }
+
+    if (GetStageName(type).empty())
+    {
+      Logger::EchoError("Unsupported shader type", __func__);
+      return {};
+    }
+
+    if (cache_dir.empty())
+      cache_dir = GetDefaultCacheDirectory();
+
+    std::error_code ec;
+    std::filesystem::create_directories(cache_dir, ec);
+    if (ec)
+      Logger::EchoWarning("Can't create shader cache directory " + cache_dir.string(), __func__);
+
+    auto key = GetCacheKey(source, type, defines);
+    auto hash = GetKeyHash(key);
+    auto spv_path = cache_dir / (hash + ".spv");
+    auto key_path = cache_dir / (hash + ".key");
+    if (std::filesystem::exists(spv_path, ec) && ReadTextFile(key_path) == key)
+    {
+      auto code = Misc::LoadShaderFromFile(spv_path.string());
+      if (!code.empty() && code.size() % sizeof(uint32_t) == 0)
+        return code;
+    }
+
+    auto code = CompileSource(source, type, defines, cache_dir, hash);
+    if (code.empty())
+      return {};
+
+    if (!WriteFile(spv_path, code.data(), code.size()) || !WriteFile(key_path, key.data(), key.size()))
+      Logger::EchoWarning("Can't write SPIR-V cache " + spv_path.string(), __func__);
+
+    return code;
+  }
+
+#ifdef USE_SHADERC
+  std::vector<char> ShaderCompiler::CompileSource(const std::string &source, const ShaderType type, const std::map<std::string, std::string> &defines, const std::filesystem::path &, const std::string &hash)
+  {
+    shaderc_shader_kind kind = shaderc_glsl_compute_shader;
+    switch ((VkShaderStageFlagBits) type)
+    {
+      case VK_SHADER_STAGE_VERTEX_BIT: kind = shaderc_glsl_vertex_shader; break;
+      case VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT: kind = shaderc_glsl_tess_control_shader; break;
+      case VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT: kind = shaderc_glsl_tess_evaluation_shader; break;
+      case VK_SHADER_STAGE_GEOMETRY_BIT: kind = shaderc_glsl_geometry_shader; break;
+      case VK_SHADER_STAGE_FRAGMENT_BIT: kind = shaderc_glsl_fragment_shader; break;
+      default: break;
+    }
+
+    shaderc::Compiler compiler;
+    shaderc::CompileOptions options;
+    for (auto &d : defines)
+      options.AddMacroDefinition(d.first, d.second);
+    options.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_2);
+    options.SetOptimizationLevel(shaderc_optimization_level_performance);
+
+    auto result = compiler.CompileGlslToSpv(source, kind, hash.c_str(), options);
+    if (result.GetCompilationStatus() != shaderc_compilation_status_success)
+    {
+      Logger::EchoError("Can't compile shader: " + result.GetErrorMessage(), __func__);
+      return {};
+    }
+
+    return std::vector<char>((const char *) result.cbegin(), (const char *) result.cend());
+  }
+#else
+  std::vector<char> ShaderCompiler::CompileSource(const std::string &source, const ShaderType type, const std::map<std::string, std::string> &defines, const std::filesystem::path &cache_dir, const std::string &hash)
+  {
+    std::stringstream tid;
+    tid << std::this_thread::get_id();
+    auto src_path = cache_dir / (hash + "_" + tid.str() + "." + GetStageName(type));
+    auto out_path = cache_dir / (hash + "_" + tid.str() + ".out");
+
+    if (!WriteFile(src_path, source.data(), source.size()))
+    {
+      Logger::EchoError("Can't write shader source " + src_path.string(), __func__);
+      return {};
+    }
+
+    auto log_path = cache_dir / (hash + "_" + tid.str() + ".log");
+    std::vector<std::string> args = { "glslangValidator", "-V", "--target-env", target_env };
+    for (auto &d : defines)
+      args.push_back("-D" + d.first + (d.second.empty() ? "" : "=" + d.second));
+    args.insert(args.end(), { src_path.string(), "-o", out_path.string() });
+
+    int status = -1;
+#ifdef __unix__
+    std::vector<char *> argv;
+    for (auto &a : args)
+      argv.push_back(a.data());
+    argv.push_back(nullptr);
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, log_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    posix_spawn_file_actions_adddup2(&actions, STDOUT_FILENO, STDERR_FILENO);
+
+    pid_t pid = 0;
+    if (posix_spawnp(&pid, argv[0], &actions, nullptr, argv.data(), environ) == 0)
+    {
+      int wstatus = 0;
+      while (waitpid(pid, &wstatus, 0) < 0 && errno == EINTR);
+      status = WIFEXITED(wstatus) ? WEXITSTATUS(wstatus) : -1;
+    }
+    else
+    {
+      Logger::EchoError("Can't run glslangValidator", __func__);
+    }
+    posix_spawn_file_actions_destroy(&actions);
+#else
+    std::string cmd;
+    bool safe = true;
+    for (auto &a : args)
+    {
+      safe = safe && a.find_first_of("\"%^&|<>") == std::string::npos;
+      cmd += "\"" + a + "\" ";
+    }
+    cmd += "> \"" + log_path.string() + "\" 2>&1";
+    if (safe)
+      status = std::system(cmd.c_str());
+    else
+      Logger::EchoError("Unsupported character in shader compiler arguments", __func__);
+#endif
+
+    std::vector<char> code;
+    if (status == 0)
+      code = Misc::LoadShaderFromFile(out_path.string());
+    else
+      Logger::EchoError("Can't compile shader with glslangValidator:\n" + ReadTextFile(log_path), __func__);
+
+    std::error_code ec;
+    std::filesystem::remove(src_path, ec);
+    std::filesystem::remove(out_path, ec);
+    std::filesystem::remove(log_path, ec);
+
+    return code;
+  }
+#endif
+}
\ No newline at end of file
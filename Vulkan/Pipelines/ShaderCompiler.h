@@ -0,0 +1,57 @@
+#ifndef __VULKAN_SHADER_COMPILER_H
+#define __VULKAN_SHADER_COMPILER_H
+
+#include "../Logger.h"
+#include "../Misc.h"
+#include "Types.h"
+
+#include <vulkan/vulkan.h>
+#include <vector>
+#include <map>
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <iomanip>
+#include <fstream>
+#include <filesystem>
+#include <thread>
+#include <cstdlib>
+
+#ifdef __unix__
+#include <spawn.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <cerrno>
+#endif
+
+#ifdef USE_SHADERC
+#include <shaderc/shaderc.hpp>
+#endif
+
+namespace Vulkan
+{
+  class ShaderCompiler
+  {
+  private:
+    static constexpr const char *target_env = "vulkan1.2";
+#ifdef USE_SHADERC
+    static constexpr const char *backend = "shaderc";
+#else
+    static constexpr const char *backend = "glslangValidator";
+#endif
+
+    static std::string GetStageName(const ShaderType type) noexcept;
+    static std::string GetCacheKey(const std::string &source, const ShaderType type, const std::map<std::string, std::string> &defines);
+    static std::string GetKeyHash(const std::string &key);
+    static std::string ReadTextFile(const std::filesystem::path &file_path);
+    static std::vector<char> CompileSource(const std::string &source, const ShaderType type, const std::map<std::string, std::string> &defines, const std::filesystem::path &cache_dir, const std::string &hash);
+    static bool WriteFile(const std::filesystem::path &file_path, const char *data, const size_t size);
+  public:
+    ShaderCompiler() = delete;
+    static std::filesystem::path GetDefaultCacheDirectory();
+    static std::vector<char> Compile(const std::string &source, const ShaderType type, const std::map<std::string, std::string> &defines = {}, std::filesystem::path cache_dir = {});
+  };
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,353 @@
+#include "ShaderReflection.h"
+
+namespace Vulkan
+{
+  ShaderReflection::ShaderReflection(const std::vector<char> &code, const std::string entry)
+  {
+    if (code.size() % sizeof(uint32_t) != 0)
+    {
+      Logger::EchoError("Invalid SPIR-V size", __func__);
+      return;
+    }
+
+    std::vector<uint32_t> words(code.size() / sizeof(uint32_t));
+    std::memcpy(words.data(), code.data(), words.size() * sizeof(uint32_t));
+    Parse(words.data(), words.size(), entry);
+  }
+
+  ShaderReflection::ShaderReflection(const std::vector<uint32_t> &code, const std::string entry)
+  {
+    Parse(code.data(), code.size(), entry);
+  }
+
+  void ShaderReflection::Parse(const uint32_t *code, const size_t words_count, const std::string &entry)
+  {
+    if (words_count < SpirvHeaderWords || code[0] != SpirvMagic)
+    {
+      Logger::EchoError("Invalid SPIR-V header", __func__);
+      return;
+    }
+
+    std::optional<uint32_t> entry_id;
+    std::optional<uint32_t> execution_model;
+    std::vector<std::pair<uint32_t, size_t>> modes;
+    std::vector<std::array<uint32_t, 3>> variables;
+
+    for (size_t i = SpirvHeaderWords; i < words_count;)
+    {
+      uint32_t op = code[i] & 0xffff;
+      uint32_t count = code[i] >> 16;
+      if (count == 0 || i + count > words_count)
+      {
+        Logger::EchoError("Invalid SPIR-V instruction", __func__);
+        return;
+      }
+
+      const uint32_t *args = code + i + 1;
+      switch (op)
+      {
+        case OpEntryPoint:
+          if (count > 3 && ReadString(args + 2, count - 3) == entry)
+          {
+            execution_model = args[0];
+            entry_id = args[1];
+          }
+          break;
+        case OpExecutionMode:
+        case OpExecutionModeId:
+          modes.push_back({ op, i });
+          break;
+        case OpTypeBool:
+        case OpTypeInt:
+        case OpTypeFloat:
+        case OpTypeVector:
+        case OpTypeMatrix:
+        case OpTypeImage:
+        case OpTypeSampler:
+        case OpTypeSampledImage:
+        case OpTypeArray:
+        case OpTypeRuntimeArray:
+        case OpTypeStruct:
+        case OpTypePointer:
+          types[args[0]] = std::vector<uint32_t>(args, args + count - 1);
+          types[args[0]][0] = op;
+          break;
+        case OpConstant:
+        case OpSpecConstant:
+          if (count > 3)
+            constants[args[1]] = args[2];
+          break;
+        case OpConstantComposite:
+        case OpSpecConstantComposite:
+          if (count > 3)
+            composites[args[1]] = std::vector<uint32_t>(args + 2, args + count - 1);
+          break;
+        case OpVariable:
+          if (count > 3)
+            variables.push_back({ args[0], args[1], args[2] });
+          break;
+        case OpDecorate:
+          if (count > 2)
+            decorations[args[0]][args[1]] = count > 3 ? args[2] : 1;
+          break;
+        case OpMemberDecorate:
+          if (count > 3)
+            member_decorations[args[0]][args[1]][args[2]] = count > 4 ? args[3] : 1;
+          break;
+      }
+
+      i += count;
+    }
+
+    if (!entry_id.has_value())
+    {
+      Logger::EchoError("No entry point " + entry, __func__);
+      return;
+    }
+
+    switch (execution_model.value())
+    {
+      case ExecutionModelVertex: stage = VK_SHADER_STAGE_VERTEX_BIT; break;
+      case ExecutionModelTessellationControl: stage = VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT; break;
+      case ExecutionModelTessellationEvaluation: stage = VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT; break;
+      case ExecutionModelGeometry: stage = VK_SHADER_STAGE_GEOMETRY_BIT; break;
+      case ExecutionModelFragment: stage = VK_SHADER_STAGE_FRAGMENT_BIT; break;
+      case ExecutionModelGLCompute: stage = VK_SHADER_STAGE_COMPUTE_BIT; break;
+      default:
+        Logger::EchoError("Unsupported execution model", __func__);
+        return;
+    }
+
+    for (auto &m : modes)
+    {
+      const uint32_t *args = code + m.second + 1;
+      uint32_t count = code[m.second] >> 16;
+      if (count < 6 || args[0] != entry_id.value())
+        continue;
+
+      if (m.first == OpExecutionMode && args[1] == ExecutionModeLocalSize)
+      {
+        for (size_t d = 0; d < 3; ++d)
+          local_size[d] = { args[2 + d], {} };
+      }
+
+      if (m.first == OpExecutionModeId && args[1] == ExecutionModeLocalSizeId)
+      {
+        for (size_t d = 0; d < 3; ++d)
+          local_size[d] = { ResolveConstant(args[2 + d], 1), args[2 + d] };
+      }
+    }
+
+    for (auto &c : composites)
+    {
+      if (GetDecoration(c.first, DecorationBuiltIn) != BuiltInWorkgroupSize || c.second.size() != 3)
+        continue;
+
+      for (size_t d = 0; d < 3; ++d)
+        local_size[d] = { ResolveConstant(c.second[d], local_size[d].value), c.second[d] };
+    }
+
+    for (auto &v : variables)
+      ParseVariable(v[0], v[1], v[2]);
+
+    std::sort(bindings.begin(), bindings.end(), [] (const auto &a, const auto &b) { return a.set != b.set ? a.set < b.set : a.binding < b.binding; });
+
+    valid = true;
+  }
+
+  void ShaderReflection::ParseVariable(const uint32_t type_id, const uint32_t var_id, const uint32_t storage)
+  {
+    auto ptr = types.find(type_id);
+    if (ptr == types.end() || ptr->second[0] != OpTypePointer || ptr->second.size() < 3)
+      return;
+
+    uint32_t pointee = ptr->second[2];
+
+    if (storage == StorageClassPushConstant)
+    {
+      if (auto size = GetTypeSize(pointee); size > 0)
+        push_constant_ranges.push_back({ (VkShaderStageFlags) stage, 0, size });
+      return;
+    }
+
+    if (storage != StorageClassUniformConstant && storage != StorageClassUniform && storage != StorageClassStorageBuffer)
+      return;
+
+    auto set = GetDecoration(var_id, DecorationDescriptorSet);
+    auto binding = GetDecoration(var_id, DecorationBinding);
+    if (!set.has_value() || !binding.has_value())
+      return;
+
+    ShaderBinding ret;
+    ret.set = set.value();
+    ret.binding = binding.value();
+    ret.stage = stage;
+
+    for (auto it = types.find(pointee); it != types.end(); it = types.find(pointee))
+    {
+      if (it->second[0] == OpTypeArray && it->second.size() > 2)
+      {
+        ret.count *= ResolveConstant(it->second[2], 1);
+        pointee = it->second[1];
+      }
+      else if (it->second[0] == OpTypeRuntimeArray && it->second.size() > 1)
+      {
+        ret.count = 0;
+        pointee = it->second[1];
+      }
+      else
+        break;
+    }
+
+    auto type = types.find(pointee);
+    if (type == types.end())
+      return;
+
+    switch (type->second[0])
+    {
+      case OpTypeStruct:
+        if (storage == StorageClassStorageBuffer || GetDecoration(pointee, DecorationBufferBlock).has_value())
+          ret.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        else
+          ret.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        break;
+      case OpTypeSampler:
+        ret.type = VK_DESCRIPTOR_TYPE_SAMPLER;
+        break;
+      case OpTypeSampledImage:
+        ret.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        break;
+      case OpTypeImage:
+        if (type->second.size() < 7)
+          return;
+        if (type->second[2] == DimBuffer)
+          ret.type = type->second[6] == 2 ? VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+        else
+          ret.type = type->second[6] == 2 ? VK_DESCRIPTOR_TYPE_STORAGE_IMAGE : VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+        break;
+      default:
+        return;
+    }
+
+    bindings.push_back(ret);
+  }
+
+  std::optional<uint32_t> ShaderReflection::GetDecoration(const uint32_t id, const uint32_t decoration) const
+  {
+    auto it = decorations.find(id);
+    if (it == decorations.end())
+      return {};
+
+    auto d = it->second.find(decoration);
+    return d != it->second.end() ? std::optional<uint32_t>(d->second) : std::optional<uint32_t>();
+  }
+
+  std::optional<uint32_t> ShaderReflection::GetMemberDecoration(const uint32_t id, const uint32_t member, const uint32_t decoration) const
+  {
+    auto it = member_decorations.find(id);
+    if (it == member_decorations.end())
+      return {};
+
+    auto m = it->second.find(member);
+    if (m == it->second.end())
+      return {};
+
+    auto d = m->second.find(decoration);
+    return d != m->second.end() ? std::optional<uint32_t>(d->second) : std::optional<uint32_t>();
+  }
+
+  uint32_t ShaderReflection::GetTypeSize(const uint32_t id) const
+  {
+    auto it = types.find(id);
+    if (it == types.end())
+      return 0;
+
+    auto &t = it->second;
+    switch (t[0])
+    {
+      case OpTypeBool:
+        return 4;
+      case OpTypeInt:
+      case OpTypeFloat:
+        return t.size() > 1 ? t[1] / 8 : 0;
+      case OpTypeVector:
+      case OpTypeMatrix:
+        return t.size() > 2 ? t[2] * GetTypeSize(t[1]) : 0;
+      case OpTypeArray:
+        if (t.size() < 3)
+          return 0;
+        return ResolveConstant(t[2], 1) * GetDecoration(id, DecorationArrayStride).value_or(GetTypeSize(t[1]));
+      case OpTypeStruct:
+      {
+        uint32_t size = 0;
+        for (uint32_t m = 0; m + 1 < t.size(); ++m)
+        {
+          uint32_t member_size = GetTypeSize(t[m + 1]);
+          auto member_type = types.find(t[m + 1]);
+          if (member_type != types.end() && member_type->second[0] == OpTypeMatrix && member_type->second.size() > 2)
+          {
+            if (auto stride = GetMemberDecoration(id, m, DecorationMatrixStride); stride.has_value())
+              member_size = member_type->second[2] * stride.value();
+          }
+          size = std::max(size, GetMemberDecoration(id, m, DecorationOffset).value_or(size) + member_size);
+        }
+        return size;
+      }
+    }
+
+    return 0;
+  }
+
+  std::string ShaderReflection::ReadString(const uint32_t *words, const size_t count)
+  {
+    std::string ret;
+    for (size_t i = 0; i < count; ++i)
+    {
+      for (size_t j = 0; j < 4; ++j)
+      {
+        char c = (char) ((words[i] >> (j * 8)) & 0xff);
+        if (c == '\0') return ret;
+        ret.push_back(c);
+      }
+    }
+    return ret;
+  }
+
+  uint32_t ShaderReflection::ResolveConstant(const uint32_t id, const uint32_t fallback) const noexcept
+  {
+    auto it = constants.find(id);
+    return it != constants.end() ? it->second : fallback;
+  }
+
+  WorkgroupSize ShaderReflection::GetWorkgroupSize(const SpecializationConstants &specialization) const
+  {
+    uint32_t size[3];
+    for (size_t d = 0; d < 3; ++d)
+    {
+      size[d] = local_size[d].value;
+      if (!local_size[d].id.has_value())
+        continue;
+
+      if (auto spec_id = GetDecoration(local_size[d].id.value(), DecorationSpecId); spec_id.has_value())
+        size[d] = specialization.GetUint32(spec_id.value()).value_or(size[d]);
+    }
+
+    WorkgroupSize ret;
+    ret.x = std::max(size[0], (uint32_t) 1);
+    ret.y = std::max(size[1], (uint32_t) 1);
+    ret.z = std::max(size[2], (uint32_t) 1);
+    return ret;
+  }
+
+  std::vector<ShaderBinding> ShaderReflection::GetBindings(const uint32_t set) const
+  {
+    std::vector<ShaderBinding> ret;
+    std::copy_if(bindings.begin(), bindings.end(), std::back_inserter(ret), [set] (const auto &b) { return b.set == set; });
+    return ret;
+  }
+
+  uint32_t ShaderReflection::GetSetsCount() const noexcept
+  {
+    return bindings.empty() ? 0 : bindings.back().set + 1;
+  }
+}
\ No newline at end of file
@@ -0,0 +1,125 @@
+#ifndef __VULKAN_SHADER_REFLECTION_H
+#define __VULKAN_SHADER_REFLECTION_H
+
+#include "../Logger.h"
+#include "Types.h"
+
+#include <vulkan/vulkan.h>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include <map>
+#include <array>
+#include <string>
+#include <optional>
+
+namespace Vulkan
+{
+  struct ShaderBinding
+  {
+    uint32_t set = 0;
+    uint32_t binding = 0;
+    VkDescriptorType type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    uint32_t count = 1;
+    VkShaderStageFlags stage = 0;
+  };
+
+  class ShaderReflection
+  {
+  private:
+    enum SpirvOp : uint32_t
+    {
+      OpEntryPoint = 15,
+      OpExecutionMode = 16,
+      OpTypeBool = 20,
+      OpTypeInt = 21,
+      OpTypeFloat = 22,
+      OpTypeVector = 23,
+      OpTypeMatrix = 24,
+      OpTypeImage = 25,
+      OpTypeSampler = 26,
+      OpTypeSampledImage = 27,
+      OpTypeArray = 28,
+      OpTypeRuntimeArray = 29,
+      OpTypeStruct = 30,
+      OpTypePointer = 32,
+      OpConstant = 43,
+      OpConstantComposite = 44,
+      OpSpecConstant = 50,
+      OpSpecConstantComposite = 51,
+      OpVariable = 59,
+      OpDecorate = 71,
+      OpMemberDecorate = 72,
+      OpExecutionModeId = 331
+    };
+
+    enum SpirvEnum : uint32_t
+    {
+      SpirvMagic = 0x07230203,
+      SpirvHeaderWords = 5,
+      ExecutionModelVertex = 0,
+      ExecutionModelTessellationControl = 1,
+      ExecutionModelTessellationEvaluation = 2,
+      ExecutionModelGeometry = 3,
+      ExecutionModelFragment = 4,
+      ExecutionModelGLCompute = 5,
+      ExecutionModeLocalSize = 17,
+      ExecutionModeLocalSizeId = 38,
+      DecorationSpecId = 1,
+      DecorationBlock = 2,
+      DecorationBufferBlock = 3,
+      DecorationArrayStride = 6,
+      DecorationMatrixStride = 7,
+      DecorationBuiltIn = 11,
+      DecorationBinding = 33,
+      DecorationDescriptorSet = 34,
+      DecorationOffset = 35,
+      BuiltInWorkgroupSize = 25,
+      StorageClassUniformConstant = 0,
+      StorageClassUniform = 2,
+      StorageClassPushConstant = 9,
+      StorageClassStorageBuffer = 12,
+      DimBuffer = 5
+    };
+
+    struct Dimension
+    {
+      uint32_t value = 1;
+      std::optional<uint32_t> id;
+    };
+
+    bool valid = false;
+    VkShaderStageFlagBits stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    std::array<Dimension, 3> local_size;
+    std::map<uint32_t, uint32_t> constants;
+    std::map<uint32_t, std::vector<uint32_t>> composites;
+    std::map<uint32_t, std::vector<uint32_t>> types;
+    std::map<uint32_t, std::map<uint32_t, uint32_t>> decorations;
+    std::map<uint32_t, std::map<uint32_t, std::map<uint32_t, uint32_t>>> member_decorations;
+    std::vector<ShaderBinding> bindings;
+    std::vector<VkPushConstantRange> push_constant_ranges;
+
+    static std::string ReadString(const uint32_t *words, const size_t count);
+    void Parse(const uint32_t *code, const size_t words_count, const std::string &entry);
+    void ParseVariable(const uint32_t type_id, const uint32_t var_id, const uint32_t storage);
+    std::optional<uint32_t> GetDecoration(const uint32_t id, const uint32_t decoration) const;
+    std::optional<uint32_t> GetMemberDecoration(const uint32_t id, const uint32_t member, const uint32_t decoration) const;
+    uint32_t ResolveConstant(const uint32_t id, const uint32_t fallback) const noexcept;
+    uint32_t GetTypeSize(const uint32_t id) const;
+  public:
+    ShaderReflection() = default;
+    ShaderReflection(const std::vector<char> &code, const std::string entry = "main");
+    ShaderReflection(const std::vector<uint32_t> &code, const std::string entry = "main");
+    ~ShaderReflection() noexcept = default;
+
+    bool IsValid() const noexcept { return valid; }
+    VkShaderStageFlagBits GetStage() const noexcept { return stage; }
+    WorkgroupSize GetWorkgroupSize(const SpecializationConstants &specialization = {}) const;
+    std::vector<ShaderBinding> GetBindings() const { return bindings; }
+    std::vector<ShaderBinding> GetBindings(const uint32_t set) const;
+    uint32_t GetSetsCount() const noexcept;
+    std::vector<VkPushConstantRange> GetPushConstantRanges() const { return push_constant_ranges; }
+  };
+}
+
+#endif
\ No newline at end of file
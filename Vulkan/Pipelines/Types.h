@@ -4,6 +4,11 @@
 #include <vulkan/vulkan.h>
 #include <string>
 #include <filesystem>
+#include <map>
+#include <vector>
+#include <optional>
+#include <cstring>
+#include <type_traits>
 
 namespace Vulkan
 {
@@ -19,6 +24,9 @@ namespace Vulkan
     std::string entry = "main";
     std::filesystem::path file_path;
     ShaderType type;
+    std::string source;
+    std::map<std::string, std::string> defines;
+    std::string embedded;
   };
 
   struct Shader
@@ -26,5 +34,74 @@ namespace Vulkan
     VkShaderModule shader = VK_NULL_HANDLE;
     std::string entry = "main";
   };
+
+  struct WorkgroupSize
+  {
+    uint32_t x = 1;
+    uint32_t y = 1;
+    uint32_t z = 1;
+  };
+
+  struct PipelineHandle
+  {
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    VkPipelineLayout layout = VK_NULL_HANDLE;
+    VkPipelineBindPoint bind_point = VK_PIPELINE_BIND_POINT_COMPUTE;
+    WorkgroupSize workgroup_size;
+  };
+
+  class SpecializationConstants
+  {
+  private:
+    std::map<uint32_t, std::vector<char>> values;
+    std::vector<VkSpecializationMapEntry> entries;
+    std::vector<char> data;
+
+    void Pack()
+    {
+      entries.clear();
+      data.clear();
+      for (auto &v : values)
+      {
+        entries.push_back({ v.first, (uint32_t) data.size(), v.second.size() });
+        data.insert(data.end(), v.second.begin(), v.second.end());
+      }
+    }
+  public:
+    SpecializationConstants() = default;
+    SpecializationConstants(const SpecializationConstants &obj) : values(obj.values) { Pack(); }
+    SpecializationConstants &operator=(const SpecializationConstants &obj) { values = obj.values; Pack(); return *this; }
+    ~SpecializationConstants() noexcept = default;
+
+    template <typename T> void Set(const uint32_t id, const T value)
+    {
+      static_assert(std::is_trivially_copyable<T>::value, "Specialization constant must be trivially copyable");
+      if constexpr (std::is_same<T, bool>::value)
+      {
+        Set<VkBool32>(id, value ? VK_TRUE : VK_FALSE);
+      }
+      else
+      {
+        std::vector<char> bytes(sizeof(T));
+        std::memcpy(bytes.data(), &value, sizeof(T));
+        values[id] = bytes;
+        Pack();
+      }
+    }
+
+    std::optional<uint32_t> GetUint32(const uint32_t id) const
+    {
+      auto it = values.find(id);
+      if (it == values.end() || it->second.size() != sizeof(uint32_t))
+        return {};
+
+      uint32_t ret = 0;
+      std::memcpy(&ret, it->second.data(), sizeof(uint32_t));
+      return ret;
+    }
+
+    bool Empty() const noexcept { return values.empty(); }
+    VkSpecializationInfo GetInfo() const noexcept { return { (uint32_t) entries.size(), entries.data(), data.size(), data.data() }; }
+  };
 }
 #endif
\ No newline at end of file
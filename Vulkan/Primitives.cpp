@@ -0,0 +1,322 @@
+#include "Primitives.h"
+
+namespace Vulkan
+{
+  Primitives_impl::~Primitives_impl() noexcept
+  {
+    Logger::EchoDebug("", __func__);
+    pipelines.clear();
+    set_cache.Clear();
+    if (device.get() != nullptr && layout != VK_NULL_HANDLE)
+      device->ReleaseDescriptorSetLayout(layout);
+  }
+
+  Primitives_impl::Primitives_impl(std::shared_ptr<Device> dev, const PrimitivesConfig &params) :
+    set_cache(dev, DescriptorSetCacheConfig().SetFramesInFlight(params.frames_in_flight).SetAllocatorConfig(DescriptorAllocatorConfig().AddPoolRatio(DescriptorType::BufferStorage, (float) bindings_count))),
+    scratch(dev)
+  {
+    if (dev.get() == nullptr || !dev->IsValid())
+    {
+      Logger::EchoError("Device is empty", __func__);
+      return;
+    }
+
+    device = dev;
+    subgroups = params.use_subgroups && IsSubgroupArithmeticSupported();
+
+    std::vector<VkDescriptorSetLayoutBinding> bindings(bindings_count);
+    for (uint32_t i = 0; i < bindings_count; ++i)
+    {
+      bindings[i].binding = i;
+      bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+      bindings[i].descriptorCount = 1;
+      bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+
+    VkDescriptorSetLayoutCreateInfo layout_create_info = {};
+    layout_create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layout_create_info.bindingCount = (uint32_t) bindings.size();
+    layout_create_info.pBindings = bindings.data();
+    layout = device->AcquireDescriptorSetLayout(layout_create_info);
+    if (layout == VK_NULL_HANDLE)
+    {
+      Logger::EchoError("Can't create DescriptorSetLayout", __func__);
+      return;
+    }
+
+    std::map<std::string, std::string> defines = {{"WG", std::to_string(workgroup_size)}};
+    if (subgroups)
+      defines["USE_SUBGROUP"] = "1";
+
+    const std::vector<std::pair<Kernel, const char *>> kernels = {
+      {Kernel::Reduce, PrimitiveKernels::reduce},
+      {Kernel::ScanBlock, PrimitiveKernels::scan_block},
+      {Kernel::ScanAdd, PrimitiveKernels::scan_add},
+      {Kernel::Compact, PrimitiveKernels::compact},
+      {Kernel::RadixHistogram, PrimitiveKernels::radix_histogram},
+      {Kernel::RadixScatter, PrimitiveKernels::radix_scatter}
+    };
+
+    for (auto &[kernel, source] : kernels)
+    {
+      ComputePipeline pipeline(device, ComputePipelineConfig().AddDescriptorSetLayout(layout)
+                                                              .SetShaderSource(std::string(PrimitiveKernels::common) + source, defines));
+      if (!pipeline.IsValid())
+      {
+        Logger::EchoError("Can't build primitive kernel " + std::to_string((int) kernel), __func__);
+        return;
+      }
+      pipelines.emplace(kernel, std::move(pipeline));
+    }
+
+    scratch_align = std::max<VkDeviceSize>(device->GetPhysicalDeviceProperties().limits.minStorageBufferOffsetAlignment, 4);
+    const uint64_t max_threads = (uint64_t) device->GetPhysicalDeviceProperties().limits.maxComputeWorkGroupCount[0] * workgroup_size;
+    const uint32_t max_count = (uint32_t) std::min<uint64_t>(params.max_elements, max_threads);
+    if (max_count < params.max_elements)
+      Logger::EchoWarning("Max elements count is clamped to " + std::to_string(max_count) + " by maxComputeWorkGroupCount", __func__);
+
+    uint64_t blocks = ((uint64_t) max_count + workgroup_size - 1) / workgroup_size;
+    uint64_t elements = 2 * (uint64_t) max_count + 16 * blocks + 2 * ((16 * blocks + workgroup_size * items_per_thread - 1) / (workgroup_size * items_per_thread)) + 64;
+    frame_scratch_size = (elements * sizeof(uint32_t) + 32 * scratch_align + scratch_align - 1) / scratch_align * scratch_align;
+    VkDeviceSize scratch_size = scratch_align + frame_scratch_size * params.frames_in_flight;
+
+    scratch.StartConfig(HostVisibleMemory::HostInvisible);
+    scratch.AddBuffer(BufferConfig().AddSubBuffer(scratch_size, 1).SetType(StorageType::Storage));
+    if (auto er = scratch.EndConfig(); er != VK_SUCCESS)
+    {
+      Logger::EchoError("Can't allocate scratch memory", __func__);
+      Logger::EchoDebug("Return code = " + std::to_string(er), __func__);
+      return;
+    }
+
+    dummy = { scratch.GetInfo(0).buffer, 0, scratch_align };
+    scratch_used = scratch_align;
+    frames_in_flight = params.frames_in_flight;
+    max_elements = max_count;
+  }
+
+  bool Primitives_impl::IsSubgroupArithmeticSupported() const
+  {
+    VkPhysicalDeviceSubgroupProperties subgroup_props = {};
+    subgroup_props.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_PROPERTIES;
+    VkPhysicalDeviceProperties2 props = {};
+    props.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    props.pNext = &subgroup_props;
+    vkGetPhysicalDeviceProperties2(device->GetPhysicalDevice(), &props);
+
+    const VkSubgroupFeatureFlags required = VK_SUBGROUP_FEATURE_BASIC_BIT | VK_SUBGROUP_FEATURE_ARITHMETIC_BIT;
+    return (subgroup_props.supportedStages & VK_SHADER_STAGE_COMPUTE_BIT) && (subgroup_props.supportedOperations & required) == required;
+  }
+
+  void Primitives_impl::BeginFrame()
+  {
+    set_cache.BeginFrame();
+    frame_index = (frame_index + 1) % frames_in_flight;
+  }
+
+  std::optional<BufferRange> Primitives_impl::Allocate(const uint32_t count)
+  {
+    VkDeviceSize size = std::max<VkDeviceSize>((VkDeviceSize) count * sizeof(uint32_t), sizeof(uint32_t));
+    VkDeviceSize offset = (scratch_used + scratch_align - 1) / scratch_align * scratch_align;
+    auto info = scratch.GetInfo(0);
+    if (offset + size > GetFrameScratchOffset() + frame_scratch_size)
+    {
+      Logger::EchoError("Not enough scratch memory", __func__);
+      return {};
+    }
+
+    scratch_used = offset + size;
+    return BufferRange{ info.buffer, offset, size };
+  }
+
+  VkResult Primitives_impl::Dispatch(CommandBuffer &cmd, const Kernel kernel, const std::array<BufferRange, bindings_count> &buffers, const Params &params, const uint32_t groups)
+  {
+    LayoutConfig info;
+    for (uint32_t i = 0; i < bindings_count; ++i)
+    {
+      auto &range = buffers[i].buffer != VK_NULL_HANDLE && buffers[i].size > 0 ? buffers[i] : dummy;
+      DescriptorInfo desc_info;
+      desc_info.type = DescriptorType::BufferStorage;
+      desc_info.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+      desc_info.binding = i;
+      desc_info.buffer_info.buffer = range.buffer;
+      desc_info.offset = range.offset;
+      desc_info.size = range.size;
+      info.AddBufferOrImage(desc_info);
+    }
+
+    VkDescriptorSet set = VK_NULL_HANDLE;
+    if (auto er = set_cache.GetDescriptorSet(layout, info, set); er != VK_SUCCESS)
+    {
+      Logger::EchoError("Can't get DescriptorSet", __func__);
+      return er;
+    }
+
+    auto &pipeline = pipelines.at(kernel);
+    cmd.BindPipeline(pipeline)
+       .BindDescriptorSets(pipeline.GetLayout(), VK_PIPELINE_BIND_POINT_COMPUTE, {set}, 0, {})
+       .PushConstants(pipeline.GetLayout(), VK_SHADER_STAGE_COMPUTE_BIT, params)
+       .Dispatch(groups, 1, 1)
+       .ComputeBarrier();
+    return VK_SUCCESS;
+  }
+
+  VkResult Primitives_impl::ScanRecursive(CommandBuffer &cmd, const BufferRange &input, const BufferRange &output, const uint32_t count, const bool inclusive, const bool predicate)
+  {
+    const uint32_t block = workgroup_size * items_per_thread;
+    uint32_t groups = (count + block - 1) / block;
+    auto sums = Allocate(groups);
+    if (!sums.has_value())
+      return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+
+    if (auto er = Dispatch(cmd, Kernel::ScanBlock, {input, output, *sums}, {count, inclusive, predicate}, groups); er != VK_SUCCESS)
+      return er;
+    if (groups == 1)
+      return VK_SUCCESS;
+
+    if (auto er = ScanRecursive(cmd, *sums, *sums, groups, false, false); er != VK_SUCCESS)
+      return er;
+
+    return Dispatch(cmd, Kernel::ScanAdd, {BufferRange{}, output, *sums}, {count}, (count + workgroup_size - 1) / workgroup_size);
+  }
+
+  VkResult Primitives_impl::Reduce(CommandBuffer &cmd, const BufferRange &input, const BufferRange &output, const uint32_t count, const ReduceOp op, const ElementType type)
+  {
+    if (count == 0 || count > max_elements)
+    {
+      Logger::EchoError("Invalid elements count", __func__);
+      return VK_ERROR_UNKNOWN;
+    }
+
+    scratch_used = GetFrameScratchOffset();
+    const uint32_t block = workgroup_size * items_per_thread;
+    uint32_t groups = (count + block - 1) / block;
+    std::array<std::optional<BufferRange>, 2> partials = { Allocate(groups), Allocate(groups) };
+    if (!partials[0].has_value() || !partials[1].has_value())
+      return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+
+    cmd.ComputeBarrier();
+    BufferRange src = input;
+    uint32_t n = count;
+    for (size_t pass = 0; ; ++pass)
+    {
+      groups = (n + block - 1) / block;
+      BufferRange dst = groups == 1 ? output : *partials[pass % 2];
+      if (auto er = Dispatch(cmd, Kernel::Reduce, {src, dst}, {n, (uint32_t) op, (uint32_t) type}, groups); er != VK_SUCCESS)
+        return er;
+      if (groups == 1)
+        break;
+
+      src = dst;
+      n = groups;
+    }
+
+    return VK_SUCCESS;
+  }
+
+  VkResult Primitives_impl::Scan(CommandBuffer &cmd, const BufferRange &input, const BufferRange &output, const uint32_t count, const bool inclusive)
+  {
+    if (count == 0 || count > max_elements)
+    {
+      Logger::EchoError("Invalid elements count", __func__);
+      return VK_ERROR_UNKNOWN;
+    }
+
+    scratch_used = GetFrameScratchOffset();
+    cmd.ComputeBarrier();
+    return ScanRecursive(cmd, input, output, count, inclusive, false);
+  }
+
+  VkResult Primitives_impl::Compact(CommandBuffer &cmd, const BufferRange &values, const BufferRange &flags, const BufferRange &output, const BufferRange &output_count, const uint32_t count)
+  {
+    if (count > max_elements)
+    {
+      Logger::EchoError("Invalid elements count", __func__);
+      return VK_ERROR_UNKNOWN;
+    }
+
+    cmd.ComputeBarrier();
+    if (count == 0)
+    {
+      cmd.FillBuffer(output_count.buffer, output_count.offset, sizeof(uint32_t), 0).ComputeBarrier();
+      return VK_SUCCESS;
+    }
+
+    scratch_used = GetFrameScratchOffset();
+    auto indices = Allocate(count);
+    if (!indices.has_value())
+      return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+
+    if (auto er = ScanRecursive(cmd, flags, *indices, count, false, true); er != VK_SUCCESS)
+      return er;
+
+    return Dispatch(cmd, Kernel::Compact, {values, flags, *indices, output, output_count}, {count}, (count + workgroup_size - 1) / workgroup_size);
+  }
+
+  VkResult Primitives_impl::RadixSort(CommandBuffer &cmd, const BufferRange &keys, const BufferRange &values, const uint32_t count)
+  {
+    if (count > max_elements)
+    {
+      Logger::EchoError("Invalid elements count", __func__);
+      return VK_ERROR_UNKNOWN;
+    }
+
+    if (count < 2)
+      return VK_SUCCESS;
+
+    scratch_used = GetFrameScratchOffset();
+    const bool has_values = values.buffer != VK_NULL_HANDLE && values.size > 0;
+    const uint32_t blocks = (count + workgroup_size - 1) / workgroup_size;
+    auto tmp_keys = Allocate(count);
+    auto tmp_values = has_values ? Allocate(count) : std::optional<BufferRange>(BufferRange{});
+    auto offsets = Allocate(16 * blocks);
+    if (!tmp_keys.has_value() || !tmp_values.has_value() || !offsets.has_value())
+      return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+
+    cmd.ComputeBarrier();
+    std::array<BufferRange, 2> key_buffers = { keys, *tmp_keys };
+    std::array<BufferRange, 2> value_buffers = { values, *tmp_values };
+    auto mark = scratch_used;
+    for (uint32_t pass = 0; pass < 8; ++pass)
+    {
+      auto &src_keys = key_buffers[pass % 2];
+      auto &dst_keys = key_buffers[(pass + 1) % 2];
+      auto &src_values = value_buffers[pass % 2];
+      auto &dst_values = value_buffers[(pass + 1) % 2];
+      uint32_t shift = pass * 4;
+
+      if (auto er = Dispatch(cmd, Kernel::RadixHistogram, {src_keys, *offsets}, {count, shift, blocks}, blocks); er != VK_SUCCESS)
+        return er;
+      if (auto er = ScanRecursive(cmd, *offsets, *offsets, 16 * blocks, false, false); er != VK_SUCCESS)
+        return er;
+      if (auto er = Dispatch(cmd, Kernel::RadixScatter, {src_keys, src_values, *offsets, dst_keys, dst_values}, {count, shift, blocks, has_values}, blocks); er != VK_SUCCESS)
+        return er;
+
+      scratch_used = mark;
+    }
+
+    return VK_SUCCESS;
+  }
+
+  Primitives &Primitives::operator=(Primitives &&obj) noexcept
+  {
+    if (&obj == this) return *this;
+
+    impl = std::move(obj.impl);
+    return *this;
+  }
+
+  void Primitives::swap(Primitives &obj) noexcept
+  {
+    if (&obj == this) return;
+
+    impl.swap(obj.impl);
+  }
+
+  void swap(Primitives &lhs, Primitives &rhs) noexcept
+  {
+    if (&lhs == &rhs) return;
+
+    lhs.swap(rhs);
+  }
+}
\ No newline at end of file
@@ -0,0 +1,146 @@
+#ifndef __VULKAN_PRIMITIVES_H
+#define __VULKAN_PRIMITIVES_H
+
+#include "Logger.h"
+#include "Device.h"
+#include "StorageArray.h"
+#include "Descriptors.h"
+#include "DescriptorSetCache.h"
+#include "CommandBuffer.h"
+#include "Pipelines/ComputePipeline.h"
+#include "Primitives/Kernels.h"
+
+#include <vulkan/vulkan.h>
+#include <memory>
+#include <vector>
+#include <array>
+#include <map>
+#include <optional>
+
+namespace Vulkan
+{
+  enum class ReduceOp
+  {
+    Add = 0,
+    Min = 1,
+    Max = 2
+  };
+
+  enum class ElementType
+  {
+    Uint = 0,
+    Int = 1,
+    Float = 2
+  };
+
+  class PrimitivesConfig
+  {
+  private:
+    friend class Primitives_impl;
+    uint32_t max_elements = 1 << 20;
+    uint32_t frames_in_flight = 2;
+    bool use_subgroups = true;
+  public:
+    PrimitivesConfig() = default;
+    ~PrimitivesConfig() noexcept = default;
+    auto &SetMaxElements(const uint32_t count) { if (count > 0) max_elements = count; return *this; }
+    auto &SetFramesInFlight(const uint32_t count) { if (count > 0) frames_in_flight = count; return *this; }
+    auto &UseSubgroups(const bool val) noexcept { use_subgroups = val; return *this; }
+  };
+
+  class Primitives_impl
+  {
+  public:
+    Primitives_impl() = delete;
+    Primitives_impl(const Primitives_impl &obj) = delete;
+    Primitives_impl(Primitives_impl &&obj) = delete;
+    Primitives_impl &operator=(const Primitives_impl &obj) = delete;
+    Primitives_impl &operator=(Primitives_impl &&obj) = delete;
+    ~Primitives_impl() noexcept;
+  private:
+    friend class Primitives;
+    enum class Kernel
+    {
+      Reduce,
+      ScanBlock,
+      ScanAdd,
+      Compact,
+      RadixHistogram,
+      RadixScatter
+    };
+
+    struct Params
+    {
+      uint32_t count = 0;
+      uint32_t param0 = 0;
+      uint32_t param1 = 0;
+      uint32_t param2 = 0;
+    };
+
+    static constexpr uint32_t workgroup_size = 256;
+    static constexpr uint32_t items_per_thread = 4;
+    static constexpr uint32_t bindings_count = 6;
+
+    std::shared_ptr<Device> device;
+    VkDescriptorSetLayout layout = VK_NULL_HANDLE;
+    std::map<Kernel, ComputePipeline> pipelines;
+    DescriptorSetCache set_cache;
+    StorageArray scratch;
+    VkDeviceSize scratch_used = 0;
+    VkDeviceSize scratch_align = 4;
+    VkDeviceSize frame_scratch_size = 0;
+    uint32_t frames_in_flight = 0;
+    uint32_t frame_index = 0;
+    BufferRange dummy;
+    uint32_t max_elements = 0;
+    bool subgroups = false;
+
+    Primitives_impl(std::shared_ptr<Device> dev, const PrimitivesConfig &params);
+    bool IsSubgroupArithmeticSupported() const;
+    VkDeviceSize GetFrameScratchOffset() const noexcept { return dummy.size + frame_index * frame_scratch_size; }
+    std::optional<BufferRange> Allocate(const uint32_t count);
+    VkResult Dispatch(CommandBuffer &cmd, const Kernel kernel, const std::array<BufferRange, bindings_count> &buffers, const Params &params, const uint32_t groups);
+    VkResult ScanRecursive(CommandBuffer &cmd, const BufferRange &input, const BufferRange &output, const uint32_t count, const bool inclusive, const bool predicate);
+
+    VkResult Reduce(CommandBuffer &cmd, const BufferRange &input, const BufferRange &output, const uint32_t count, const ReduceOp op, const ElementType type);
+    VkResult Scan(CommandBuffer &cmd, const BufferRange &input, const BufferRange &output, const uint32_t count, const bool inclusive);
+    VkResult Compact(CommandBuffer &cmd, const BufferRange &values, const BufferRange &flags, const BufferRange &output, const BufferRange &output_count, const uint32_t count);
+    VkResult RadixSort(CommandBuffer &cmd, const BufferRange &keys, const BufferRange &values, const uint32_t count);
+    void BeginFrame();
+    bool IsSubgroupEnabled() const noexcept { return subgroups; }
+    uint32_t GetMaxElements() const noexcept { return max_elements; }
+    std::shared_ptr<Device> GetDevice() const noexcept { return device; }
+  };
+
+  class Primitives
+  {
+  private:
+    std::unique_ptr<Primitives_impl> impl;
+  public:
+    Primitives() = delete;
+    Primitives(const Primitives &obj) = delete;
+    Primitives(Primitives &&obj) noexcept : impl(std::move(obj.impl)) {};
+    Primitives(std::shared_ptr<Device> dev, const PrimitivesConfig &params = {}) :
+      impl(std::unique_ptr<Primitives_impl>(new Primitives_impl(dev, params))) {};
+    Primitives &operator=(const Primitives &obj) = delete;
+    Primitives &operator=(Primitives &&obj) noexcept;
+    ~Primitives() noexcept = default;
+    void swap(Primitives &obj) noexcept;
+    bool IsValid() const noexcept { return impl.get() && impl->max_elements > 0; }
+
+    VkResult Reduce(CommandBuffer &cmd, const BufferRange &input, const BufferRange &output, const uint32_t count, const ReduceOp op = ReduceOp::Add, const ElementType type = ElementType::Uint) { if (IsValid()) return impl->Reduce(cmd, input, output, count, op, type); return VK_ERROR_UNKNOWN; }
+    VkResult ExclusiveScan(CommandBuffer &cmd, const BufferRange &input, const BufferRange &output, const uint32_t count) { if (IsValid()) return impl->Scan(cmd, input, output, count, false); return VK_ERROR_UNKNOWN; }
+    VkResult InclusiveScan(CommandBuffer &cmd, const BufferRange &input, const BufferRange &output, const uint32_t count) { if (IsValid()) return impl->Scan(cmd, input, output, count, true); return VK_ERROR_UNKNOWN; }
+    VkResult Compact(CommandBuffer &cmd, const BufferRange &values, const BufferRange &flags, const BufferRange &output, const BufferRange &output_count, const uint32_t count) { if (IsValid()) return impl->Compact(cmd, values, flags, output, output_count, count); return VK_ERROR_UNKNOWN; }
+    VkResult RadixSort(CommandBuffer &cmd, const BufferRange &keys, const uint32_t count, const BufferRange &values = {}) { if (IsValid()) return impl->RadixSort(cmd, keys, values, count); return VK_ERROR_UNKNOWN; }
+    // Operations recorded between two BeginFrame calls share one scratch region and must be submitted in order on one queue
+    void BeginFrame() { if (IsValid()) impl->BeginFrame(); }
+    bool IsSubgroupEnabled() const noexcept { if (impl.get()) return impl->IsSubgroupEnabled(); return false; }
+    uint32_t GetMaxElements() const noexcept { if (impl.get()) return impl->GetMaxElements(); return 0; }
+    std::shared_ptr<Device> GetDevice() const noexcept { if (impl.get()) return impl->GetDevice(); return nullptr; }
+  };
+
+  void swap(Primitives &lhs, Primitives &rhs) noexcept;
+}
+
+#endif
\ No newline at end of file
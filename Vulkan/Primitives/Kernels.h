@@ -0,0 +1,288 @@
+#ifndef __VULKAN_PRIMITIVES_KERNELS_H
+#define __VULKAN_PRIMITIVES_KERNELS_H
+
+namespace Vulkan
+{
+  struct PrimitiveKernels
+  {
+    static constexpr const char *common = R"(
+#version 450
+#ifdef USE_SUBGROUP
+#extension GL_KHR_shader_subgroup_basic : require
+#extension GL_KHR_shader_subgroup_arithmetic : require
+#endif
+
+layout (local_size_x = WG, local_size_y = 1, local_size_z = 1) in;
+
+layout(std430, binding = 0) buffer Buffer0 { uint b0[]; };
+layout(std430, binding = 1) buffer Buffer1 { uint b1[]; };
+layout(std430, binding = 2) buffer Buffer2 { uint b2[]; };
+layout(std430, binding = 3) buffer Buffer3 { uint b3[]; };
+layout(std430, binding = 4) buffer Buffer4 { uint b4[]; };
+layout(std430, binding = 5) buffer Buffer5 { uint b5[]; };
+
+layout(push_constant) uniform Params
+{
+  uint count;
+  uint param0;
+  uint param1;
+  uint param2;
+} p;
+
+shared uint s_data[WG];
+shared uint s_total;
+
+uint WorkgroupInclusiveAdd(uint v)
+{
+  uint lid = gl_LocalInvocationID.x;
+#ifdef USE_SUBGROUP
+  uint x = subgroupInclusiveAdd(v);
+  if (gl_SubgroupInvocationID == gl_SubgroupSize - 1)
+    s_data[gl_SubgroupID] = x;
+  barrier();
+  if (lid == 0)
+  {
+    uint r = 0;
+    for (uint i = 0; i < gl_NumSubgroups; ++i)
+    {
+      uint t = s_data[i];
+      s_data[i] = r;
+      r += t;
+    }
+  }
+  barrier();
+  x += s_data[gl_SubgroupID];
+  barrier();
+  return x;
+#else
+  s_data[lid] = v;
+  barrier();
+  for (uint offset = 1; offset < WG; offset <<= 1)
+  {
+    uint t = lid >= offset ? s_data[lid - offset] : 0;
+    barrier();
+    s_data[lid] += t;
+    barrier();
+  }
+  uint x = s_data[lid];
+  barrier();
+  return x;
+#endif
+}
+)";
+
+    static constexpr const char *reduce = R"(
+uint Identity()
+{
+  if (p.param0 == 0)
+    return 0u;
+  if (p.param0 == 1)
+    return p.param1 == 0 ? 0xFFFFFFFFu : (p.param1 == 1 ? 0x7FFFFFFFu : 0x7F800000u);
+  return p.param1 == 0 ? 0u : (p.param1 == 1 ? 0x80000000u : 0xFF800000u);
+}
+
+uint Combine(uint a, uint b)
+{
+  if (p.param1 == 2)
+  {
+    float x = uintBitsToFloat(a);
+    float y = uintBitsToFloat(b);
+    return floatBitsToUint(p.param0 == 0 ? x + y : (p.param0 == 1 ? min(x, y) : max(x, y)));
+  }
+
+  if (p.param1 == 1)
+  {
+    int x = int(a);
+    int y = int(b);
+    return uint(p.param0 == 0 ? x + y : (p.param0 == 1 ? min(x, y) : max(x, y)));
+  }
+
+  return p.param0 == 0 ? a + b : (p.param0 == 1 ? min(a, b) : max(a, b));
+}
+
+#ifdef USE_SUBGROUP
+uint SubgroupReduce(uint v)
+{
+  if (p.param1 == 2)
+  {
+    float x = uintBitsToFloat(v);
+    if (p.param0 == 0) x = subgroupAdd(x);
+    else if (p.param0 == 1) x = subgroupMin(x);
+    else x = subgroupMax(x);
+    return floatBitsToUint(x);
+  }
+
+  if (p.param1 == 1)
+  {
+    int x = int(v);
+    if (p.param0 == 0) x = subgroupAdd(x);
+    else if (p.param0 == 1) x = subgroupMin(x);
+    else x = subgroupMax(x);
+    return uint(x);
+  }
+
+  if (p.param0 == 0) return subgroupAdd(v);
+  if (p.param0 == 1) return subgroupMin(v);
+  return subgroupMax(v);
+}
+#endif
+
+uint WorkgroupReduce(uint v)
+{
+  uint lid = gl_LocalInvocationID.x;
+#ifdef USE_SUBGROUP
+  uint x = SubgroupReduce(v);
+  if (subgroupElect())
+    s_data[gl_SubgroupID] = x;
+  barrier();
+  if (lid == 0)
+  {
+    uint r = Identity();
+    for (uint i = 0; i < gl_NumSubgroups; ++i)
+      r = Combine(r, s_data[i]);
+    s_total = r;
+  }
+#else
+  s_data[lid] = v;
+  barrier();
+  for (uint stride = WG / 2; stride > 0; stride >>= 1)
+  {
+    if (lid < stride)
+      s_data[lid] = Combine(s_data[lid], s_data[lid + stride]);
+    barrier();
+  }
+  if (lid == 0)
+    s_total = s_data[0];
+#endif
+  barrier();
+  return s_total;
+}
+
+void main()
+{
+  uint base = gl_WorkGroupID.x * WG * 4 + gl_LocalInvocationID.x;
+  uint acc = Identity();
+  for (uint k = 0; k < 4; ++k)
+  {
+    uint i = base + k * WG;
+    if (i < p.count)
+      acc = Combine(acc, b0[i]);
+  }
+
+  acc = WorkgroupReduce(acc);
+  if (gl_LocalInvocationID.x == 0)
+    b1[gl_WorkGroupID.x] = acc;
+}
+)";
+
+    static constexpr const char *scan_block = R"(
+uint Load(uint i)
+{
+  if (i >= p.count)
+    return 0;
+  uint v = b0[i];
+  return p.param1 != 0 ? uint(v != 0) : v;
+}
+
+void main()
+{
+  uint base = (gl_WorkGroupID.x * WG + gl_LocalInvocationID.x) * 4;
+  uint v[4];
+  uint sum = 0;
+  for (uint k = 0; k < 4; ++k)
+  {
+    v[k] = Load(base + k);
+    sum += v[k];
+  }
+
+  uint incl = WorkgroupInclusiveAdd(sum);
+  uint run = incl - sum;
+  for (uint k = 0; k < 4; ++k)
+  {
+    if (p.param0 != 0)
+      run += v[k];
+    if (base + k < p.count)
+      b1[base + k] = run;
+    if (p.param0 == 0)
+      run += v[k];
+  }
+
+  if (gl_LocalInvocationID.x == WG - 1)
+    b2[gl_WorkGroupID.x] = incl;
+}
+)";
+
+    static constexpr const char *scan_add = R"(
+void main()
+{
+  uint i = gl_GlobalInvocationID.x;
+  if (i < p.count)
+    b1[i] += b2[i / (WG * 4)];
+}
+)";
+
+    static constexpr const char *compact = R"(
+void main()
+{
+  uint i = gl_GlobalInvocationID.x;
+  if (i >= p.count)
+    return;
+
+  bool keep = b1[i] != 0;
+  if (keep)
+    b3[b2[i]] = b0[i];
+  if (i == p.count - 1)
+    b4[0] = b2[i] + uint(keep);
+}
+)";
+
+    static constexpr const char *radix_histogram = R"(
+shared uint s_hist[16];
+
+void main()
+{
+  uint lid = gl_LocalInvocationID.x;
+  if (lid < 16)
+    s_hist[lid] = 0;
+  barrier();
+
+  uint i = gl_GlobalInvocationID.x;
+  if (i < p.count)
+    atomicAdd(s_hist[(b0[i] >> p.param0) & 15u], 1u);
+  barrier();
+
+  if (lid < 16)
+    b1[lid * p.param1 + gl_WorkGroupID.x] = s_hist[lid];
+}
+)";
+
+    static constexpr const char *radix_scatter = R"(
+void main()
+{
+  uint i = gl_GlobalInvocationID.x;
+  bool valid = i < p.count;
+  uint key = valid ? b0[i] : 0;
+  uint digit = valid ? (key >> p.param0) & 15u : 16u;
+
+  uint rank = 0;
+  for (uint d = 0; d < 16; ++d)
+  {
+    uint flag = uint(digit == d);
+    uint incl = WorkgroupInclusiveAdd(flag);
+    if (flag != 0)
+      rank = incl - 1;
+  }
+
+  if (!valid)
+    return;
+
+  uint dst = b2[digit * p.param1 + gl_WorkGroupID.x] + rank;
+  b3[dst] = key;
+  if (p.param2 != 0)
+    b4[dst] = b1[i];
+}
+)";
+  };
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,106 @@
+#include "QueryPool.h"
+
+namespace Vulkan
+{
+  TimestampQueryPool_impl::TimestampQueryPool_impl(const std::shared_ptr<Device> dev, const uint32_t count, const uint32_t family_index)
+  {
+    if (dev.get() == nullptr || !dev->IsValid())
+    {
+      Logger::EchoError("Device is empty", __func__);
+      return;
+    }
+
+    device = dev;
+    this->count = count;
+    this->family_index = family_index;
+
+    auto valid_bits = device->GetFamilyQueueProperties(family_index).timestampValidBits;
+    if (valid_bits == 0 || count == 0)
+    {
+      Logger::EchoWarning("Timestamps are not supported by the queue family", __func__);
+      return;
+    }
+
+    valid_mask = valid_bits >= 64 ? UINT64_MAX : (((uint64_t) 1 << valid_bits) - 1);
+    period = device->GetPhysicalDeviceProperties().limits.timestampPeriod;
+
+    VkQueryPoolCreateInfo query_info = {};
+    query_info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    query_info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    query_info.queryCount = count;
+    if (vkCreateQueryPool(device->GetDevice(), &query_info, nullptr, &pool) != VK_SUCCESS)
+    {
+      Logger::EchoError("Can't create query pool", __func__);
+      pool = VK_NULL_HANDLE;
+    }
+  }
+
+  TimestampQueryPool_impl::~TimestampQueryPool_impl() noexcept
+  {
+    Logger::EchoDebug("", __func__);
+    if (pool != VK_NULL_HANDLE)
+      vkDestroyQueryPool(device->GetDevice(), pool, nullptr);
+  }
+
+  std::optional<double> TimestampQueryPool_impl::GetElapsed(const uint32_t first, const uint32_t second) const
+  {
+    if (first >= count || second >= count)
+    {
+      Logger::EchoError("Query index is out of range", __func__);
+      return {};
+    }
+
+    uint64_t start = 0, end = 0;
+    if (vkGetQueryPoolResults(device->GetDevice(), pool, first, 1, sizeof(start), &start, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT) != VK_SUCCESS ||
+        vkGetQueryPoolResults(device->GetDevice(), pool, second, 1, sizeof(end), &end, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT) != VK_SUCCESS)
+      return {};
+
+    return (double) ((end - start) & valid_mask) * period;
+  }
+
+  TimestampQueryPool::TimestampQueryPool(const TimestampQueryPool &obj)
+  {
+    if (!obj.IsValid())
+    {
+      Logger::EchoError("Can't copy query pool", __func__);
+      return;
+    }
+
+    impl = std::unique_ptr<TimestampQueryPool_impl>(new TimestampQueryPool_impl(obj.impl->device, obj.impl->count, obj.impl->family_index));
+  }
+
+  TimestampQueryPool &TimestampQueryPool::operator=(const TimestampQueryPool &obj)
+  {
+    if (!obj.IsValid())
+    {
+      Logger::EchoError("Can't copy query pool", __func__);
+      return *this;
+    }
+
+    impl = std::unique_ptr<TimestampQueryPool_impl>(new TimestampQueryPool_impl(obj.impl->device, obj.impl->count, obj.impl->family_index));
+
+    return *this;
+  }
+
+  TimestampQueryPool &TimestampQueryPool::operator=(TimestampQueryPool &&obj) noexcept
+  {
+    if (&obj == this) return *this;
+
+    impl = std::move(obj.impl);
+    return *this;
+  }
+
+  void TimestampQueryPool::swap(TimestampQueryPool &obj) noexcept
+  {
+    if (&obj == this) return;
+
+    impl.swap(obj.impl);
+  }
+
+  void swap(TimestampQueryPool &lhs, TimestampQueryPool &rhs) noexcept
+  {
+    if (&lhs == &rhs) return;
+
+    lhs.swap(rhs);
+  }
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#ifndef __VULKAN_QUERY_POOL_H
+#define __VULKAN_QUERY_POOL_H
+
+#include "Logger.h"
+#include "Device.h"
+
+#include <vulkan/vulkan.h>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace Vulkan
+{
+  class TimestampQueryPool_impl
+  {
+  public:
+    TimestampQueryPool_impl() = delete;
+    TimestampQueryPool_impl(const TimestampQueryPool_impl &obj) = delete;
+    TimestampQueryPool_impl(TimestampQueryPool_impl &&obj) = delete;
+    TimestampQueryPool_impl &operator=(const TimestampQueryPool_impl &obj) = delete;
+    TimestampQueryPool_impl &operator=(TimestampQueryPool_impl &&obj) = delete;
+    ~TimestampQueryPool_impl() noexcept;
+  private:
+    friend class TimestampQueryPool;
+    std::shared_ptr<Device> device;
+    VkQueryPool pool = VK_NULL_HANDLE;
+    uint32_t count = 0;
+    uint32_t family_index = 0;
+    uint64_t valid_mask = 0;
+    double period = 0.0;
+
+    TimestampQueryPool_impl(const std::shared_ptr<Device> dev, const uint32_t count, const uint32_t family_index);
+    std::optional<double> GetElapsed(const uint32_t first, const uint32_t second) const;
+  };
+
+  class TimestampQueryPool
+  {
+  private:
+    std::unique_ptr<TimestampQueryPool_impl> impl;
+  public:
+    TimestampQueryPool() = delete;
+    TimestampQueryPool(const TimestampQueryPool &obj);
+    TimestampQueryPool(TimestampQueryPool &&obj) noexcept : impl(std::move(obj.impl)) {};
+    TimestampQueryPool(const std::shared_ptr<Device> dev, const uint32_t count, const uint32_t family_index) : impl(std::unique_ptr<TimestampQueryPool_impl>(new TimestampQueryPool_impl(dev, count, family_index))) {};
+    TimestampQueryPool &operator=(const TimestampQueryPool &obj);
+    TimestampQueryPool &operator=(TimestampQueryPool &&obj) noexcept;
+    void swap(TimestampQueryPool &obj) noexcept;
+    bool IsValid() const noexcept { return impl.get() && impl->pool != VK_NULL_HANDLE; }
+    VkQueryPool GetQueryPool() const noexcept { if (impl.get()) return impl->pool; return VK_NULL_HANDLE; }
+    uint32_t GetCount() const noexcept { if (impl.get()) return impl->count; return 0; }
+    std::optional<double> GetElapsed(const uint32_t first, const uint32_t second) const { if (IsValid()) return impl->GetElapsed(first, second); return {}; }
+    ~TimestampQueryPool() noexcept = default;
+  };
+
+  void swap(TimestampQueryPool &lhs, TimestampQueryPool &rhs) noexcept;
+}
+
+#endif
\ No newline at end of file
@@ -12,22 +12,14 @@ namespace Vulkan
 
     device = dev;
     this->flags = flags;
-    VkSemaphoreCreateInfo info = {};
-    info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
-    info.flags = this->flags;
-
-    if (auto er = vkCreateSemaphore(device->GetDevice(), &info, nullptr, &sem); er != VK_SUCCESS)
-    {
-      Logger::EchoError("Failed to create semaphore");
-      Logger::EchoDebug("Return code = " + std::to_string(er), __func__);
-    }
+    sem = device->AcquireSemaphore(this->flags);
   }
 
   Semaphore_impl::~Semaphore_impl() noexcept
   {
     Logger::EchoDebug("", __func__);
     if (sem != VK_NULL_HANDLE)
-      vkDestroySemaphore(device->GetDevice(), sem, nullptr);
+      device->ReleaseSemaphore(sem, flags, waited);
   }
 
   Semaphore::Semaphore(const Semaphore &obj)
@@ -194,17 +186,111 @@ namespace Vulkan
 
   VkResult SemaphoreArray::Add(Semaphore &&obj)
   {
-    auto ptr = std::shared_ptr<Semaphore>(new Semaphore(obj));
-    if (ptr->IsValid() && obj.impl->device == device)
+    if (!obj.IsValid() || obj.impl->device != device)
     {
-      semaphores.push_back(ptr);
-      p_semaphores.push_back(ptr->impl->sem);
-      return VK_SUCCESS;
+      Logger::EchoError("Semaphore is not valid", __func__);
+      return VK_ERROR_UNKNOWN;
     }
 
-    obj = std::move(*ptr);
-    Logger::EchoError("Fence is not valid", __func__);
+    auto ptr = std::shared_ptr<Semaphore>(new Semaphore(std::move(obj)));
+    semaphores.push_back(ptr);
+    p_semaphores.push_back(ptr->impl->sem);
+    return VK_SUCCESS;
+  }
 
-    return VK_ERROR_UNKNOWN;
+  TimelineSemaphore_impl::TimelineSemaphore_impl(const std::shared_ptr<Device> dev, const uint64_t initial_value)
+  {
+    if (dev.get() == nullptr || !dev->IsValid())
+    {
+      Logger::EchoError("Device is empty", __func__);
+      return;
+    }
+
+    if (dev->GetEnabledVulkan12Features().timelineSemaphore != VK_TRUE)
+    {
+      Logger::EchoError("Timeline semaphores are not supported", __func__);
+      return;
+    }
+
+    device = dev;
+    VkSemaphoreTypeCreateInfo type_info = {};
+    type_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    type_info.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    type_info.initialValue = initial_value;
+
+    VkSemaphoreCreateInfo info = {};
+    info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    info.pNext = &type_info;
+
+    if (auto er = vkCreateSemaphore(device->GetDevice(), &info, nullptr, &sem); er != VK_SUCCESS)
+    {
+      Logger::EchoError("Failed to create timeline semaphore", __func__);
+      Logger::EchoDebug("Return code = " + std::to_string(er), __func__);
+    }
+  }
+
+  TimelineSemaphore_impl::~TimelineSemaphore_impl() noexcept
+  {
+    Logger::EchoDebug("", __func__);
+    if (sem != VK_NULL_HANDLE)
+      vkDestroySemaphore(device->GetDevice(), sem, nullptr);
+  }
+
+  std::optional<uint64_t> TimelineSemaphore_impl::GetValue() const noexcept
+  {
+    uint64_t value = 0;
+    if (sem == VK_NULL_HANDLE || vkGetSemaphoreCounterValue(device->GetDevice(), sem, &value) != VK_SUCCESS)
+      return {};
+
+    return value;
+  }
+
+  VkResult TimelineSemaphore_impl::Wait(const uint64_t value, const uint64_t timeout) const noexcept
+  {
+    if (sem == VK_NULL_HANDLE)
+      return VK_ERROR_UNKNOWN;
+
+    VkSemaphoreWaitInfo wait_info = {};
+    wait_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+    wait_info.semaphoreCount = 1;
+    wait_info.pSemaphores = &sem;
+    wait_info.pValues = &value;
+
+    return vkWaitSemaphores(device->GetDevice(), &wait_info, timeout);
+  }
+
+  VkResult TimelineSemaphore_impl::Signal(const uint64_t value) noexcept
+  {
+    if (sem == VK_NULL_HANDLE)
+      return VK_ERROR_UNKNOWN;
+
+    VkSemaphoreSignalInfo signal_info = {};
+    signal_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SIGNAL_INFO;
+    signal_info.semaphore = sem;
+    signal_info.value = value;
+
+    return vkSignalSemaphore(device->GetDevice(), &signal_info);
+  }
+
+  TimelineSemaphore &TimelineSemaphore::operator=(TimelineSemaphore &&obj) noexcept
+  {
+    if (&obj == this) return *this;
+
+    impl = std::move(obj.impl);
+    return *this;
+  }
+
+  void TimelineSemaphore::swap(TimelineSemaphore &obj) noexcept
+  {
+    if (&obj == this) return;
+
+    impl.swap(obj.impl);
+  }
+
+  void swap(TimelineSemaphore &lhs, TimelineSemaphore &rhs) noexcept
+  {
+    if (&lhs == &rhs) return;
+
+    lhs.swap(rhs);
   }
 }
\ No newline at end of file
@@ -25,6 +25,7 @@ namespace Vulkan
     std::shared_ptr<Device> device;
     VkSemaphore sem = VK_NULL_HANDLE;
     VkSemaphoreCreateFlags flags = 0;
+    bool waited = false;
 
     Semaphore_impl(const std::shared_ptr<Device> dev, const VkSemaphoreCreateFlags flags);
     std::shared_ptr<Device> GetDevice() const noexcept { return device; }
@@ -47,6 +48,8 @@ namespace Vulkan
     bool IsValid() const noexcept { return impl.get() && impl->sem != VK_NULL_HANDLE; }
     std::shared_ptr<Device> GetDevice() const noexcept { if (impl.get()) return impl->GetDevice(); return nullptr; }
     VkSemaphore GetSemaphore() const noexcept { if (impl.get()) return impl->GetSemaphore(); return VK_NULL_HANDLE; }
+    // Call once the wait on the last signal has completed, otherwise the semaphore is destroyed instead of pooled
+    void MarkWaited() noexcept { if (impl.get()) impl->waited = true; }
     ~Semaphore() noexcept = default;
   };
 
@@ -69,6 +72,7 @@ namespace Vulkan
     VkResult Add(const std::shared_ptr<Semaphore> &obj);
     VkResult Add(Semaphore &&obj);
     size_t Count() const noexcept { return semaphores.size(); }
+    void Reserve(const size_t count) { p_semaphores.reserve(count); semaphores.reserve(count); }
     void Clear() noexcept { p_semaphores.clear(); semaphores.clear(); };
     std::shared_ptr<Semaphore> GetSemaphore(const size_t index) const noexcept { return index < semaphores.size() ? semaphores[index] : nullptr; };
     std::shared_ptr<Device> GetDevice() const noexcept { return device; }
@@ -76,8 +80,52 @@ namespace Vulkan
     ~SemaphoreArray() noexcept = default;
   };
 
+  class TimelineSemaphore_impl
+  {
+  public:
+    TimelineSemaphore_impl() = delete;
+    TimelineSemaphore_impl(const TimelineSemaphore_impl &obj) = delete;
+    TimelineSemaphore_impl(TimelineSemaphore_impl &&obj) = delete;
+    TimelineSemaphore_impl &operator=(const TimelineSemaphore_impl &obj) = delete;
+    TimelineSemaphore_impl &operator=(TimelineSemaphore_impl &&obj) = delete;
+    ~TimelineSemaphore_impl() noexcept;
+  private:
+    friend class TimelineSemaphore;
+    std::shared_ptr<Device> device;
+    VkSemaphore sem = VK_NULL_HANDLE;
+
+    TimelineSemaphore_impl(const std::shared_ptr<Device> dev, const uint64_t initial_value);
+    std::shared_ptr<Device> GetDevice() const noexcept { return device; }
+    VkSemaphore GetSemaphore() const noexcept { return sem; }
+    std::optional<uint64_t> GetValue() const noexcept;
+    VkResult Wait(const uint64_t value, const uint64_t timeout) const noexcept;
+    VkResult Signal(const uint64_t value) noexcept;
+  };
+
+  class TimelineSemaphore
+  {
+  private:
+    std::unique_ptr<TimelineSemaphore_impl> impl;
+  public:
+    TimelineSemaphore() = delete;
+    TimelineSemaphore(const TimelineSemaphore &obj) = delete;
+    TimelineSemaphore(TimelineSemaphore &&obj) noexcept : impl(std::move(obj.impl)) {};
+    TimelineSemaphore(const std::shared_ptr<Device> dev, const uint64_t initial_value = 0) : impl(std::unique_ptr<TimelineSemaphore_impl>(new TimelineSemaphore_impl(dev, initial_value))) {};
+    TimelineSemaphore &operator=(const TimelineSemaphore &obj) = delete;
+    TimelineSemaphore &operator=(TimelineSemaphore &&obj) noexcept;
+    void swap(TimelineSemaphore &obj) noexcept;
+    bool IsValid() const noexcept { return impl.get() && impl->sem != VK_NULL_HANDLE; }
+    std::shared_ptr<Device> GetDevice() const noexcept { if (impl.get()) return impl->GetDevice(); return nullptr; }
+    VkSemaphore GetSemaphore() const noexcept { if (impl.get()) return impl->GetSemaphore(); return VK_NULL_HANDLE; }
+    std::optional<uint64_t> GetValue() const noexcept { if (impl.get()) return impl->GetValue(); return {}; }
+    VkResult Wait(const uint64_t value, const uint64_t timeout = UINT64_MAX) const noexcept { if (impl.get()) return impl->Wait(value, timeout); return VK_ERROR_UNKNOWN; }
+    VkResult Signal(const uint64_t value) noexcept { if (impl.get()) return impl->Signal(value); return VK_ERROR_UNKNOWN; }
+    ~TimelineSemaphore() noexcept = default;
+  };
+
   void swap(Semaphore &lhs, Semaphore &rhs) noexcept;
   void swap(SemaphoreArray &lhs, SemaphoreArray &rhs) noexcept;
+  void swap(TimelineSemaphore &lhs, TimelineSemaphore &rhs) noexcept;
 }
 
 #endif
\ No newline at end of file
@@ -115,6 +115,7 @@ namespace Vulkan
       case StorageType::Index:
       case StorageType::Vertex:
       case StorageType::Storage:
+      case StorageType::Indirect:
         tmp_b.sub_buffer_align = device->GetPhysicalDeviceProperties().limits.minStorageBufferOffsetAlignment;
         break;
       case StorageType::Uniform:
@@ -300,6 +301,18 @@ namespace Vulkan
     lhs.swap(rhs);
   }
 
+  BufferRange BufferRange::FromSubBuffer(const StorageArray &array, const size_t index, const size_t sub_index)
+  {
+    auto info = array.GetInfo(index);
+    if (sub_index >= info.sub_buffers.size())
+    {
+      Logger::EchoError("Index is out off range", __func__);
+      return {};
+    }
+
+    return { info.buffer, info.sub_buffers[sub_index].offset, info.sub_buffers[sub_index].size };
+  }
+
   StorageArray::StorageArray(const StorageArray &obj)
   {
     if (obj.impl.get() == nullptr)
@@ -23,7 +23,8 @@ namespace Vulkan
     Vertex = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
     Index = VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
     TexelStorage = VK_BUFFER_USAGE_STORAGE_TEXEL_BUFFER_BIT,
-    TexelUniform = VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT
+    TexelUniform = VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT,
+    Indirect = (VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT)
   };
 
   enum class HostVisibleMemory
@@ -164,6 +165,14 @@ namespace Vulkan
 
   void swap(StorageArray &lhs, StorageArray &rhs) noexcept;
 
+  struct BufferRange
+  {
+    VkBuffer buffer = VK_NULL_HANDLE;
+    VkDeviceSize offset = 0;
+    VkDeviceSize size = 0;
+    static BufferRange FromSubBuffer(const StorageArray &array, const size_t index, const size_t sub_index);
+  };
+
   template <typename T>
   VkResult StorageArray_impl::GetBufferData(const size_t index, std::vector<T> &result) const
   {
@@ -0,0 +1,21 @@
+# Generates a source file with every compiled SPIR-V binary as a constexpr array.
+# Expects OUTPUT, HEADER and INPUTS ('|' separated) to be passed with -D.
+
+string(REPLACE "|" ";" INPUTS "${INPUTS}")
+
+set(arrays "")
+set(table "")
+set(index 0)
+
+foreach(file ${INPUTS})
+  get_filename_component(name ${file} NAME)
+  string(REGEX REPLACE "\\.spv$" "" name ${name})
+  file(READ ${file} hex HEX)
+  string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," bytes "${hex}")
+  string(APPEND arrays "  alignas(4) static constexpr unsigned char shader_${index}[] = { ${bytes} };\n")
+  string(APPEND table "    { \"${name}\", shader_${index}, sizeof(shader_${index}) },\n")
+  math(EXPR index "${index} + 1")
+endforeach()
+
+file(WRITE ${OUTPUT}
+"#include \"${HEADER}\"\n\nnamespace Vulkan\n{\n${arrays}\n  const EmbeddedShaders::Entry EmbeddedShaders::entries[] =\n  {\n${table}    { nullptr, nullptr, 0 }\n  };\n\n  const size_t EmbeddedShaders::entries_count = ${index};\n}\n")
@@ -4,16 +4,29 @@
 #include "Vulkan/Device.h"
 #include "Vulkan/StorageArray.h"
 #include "Vulkan/Descriptors.h"
+#include "Vulkan/DescriptorAllocator.h"
+#include "Vulkan/DescriptorSetCache.h"
+#include "Vulkan/BindlessDescriptors.h"
 #include "Vulkan/CommandPool.h"
 #include "Vulkan/Pipelines.h"
 #include "Vulkan/RenderPass.h"
 #include "Vulkan/ImageArray.h"
 #include "Vulkan/Fence.h"
+#include "Vulkan/Semaphore.h"
+#include "Vulkan/Autotuner.h"
+#include "Vulkan/Primitives.h"
+#include "Vulkan/Gemm.h"
+#include "Vulkan/QueryPool.h"
 
 #include <iostream>
 #include <vector>
 #include <memory>
 #include <optional>
+#include <numeric>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <thread>
 #include <gtest/gtest.h>
 
 struct UniformData
@@ -99,8 +112,122 @@ TEST (Vulkan, Descriptors)
   EXPECT_EQ(desc.GetLayoutsCount(), 1);
   EXPECT_NE(desc.GetDescriptorSet(0), (VkDescriptorSet) VK_NULL_HANDLE);
   EXPECT_NE(desc.GetDescriptorSetLayout(0), (VkDescriptorSetLayout) VK_NULL_HANDLE);
+  EXPECT_EQ(desc.UpdateDescriptorSet(0, conf), VK_SUCCESS);
+  EXPECT_NE(desc.UpdateDescriptorSet(0, Vulkan::LayoutConfig().AddBufferOrImage(info)), VK_SUCCESS);
+  EXPECT_EQ(desc.UpdateBinding(0, 1, info), VK_SUCCESS);
+  EXPECT_NE(desc.UpdateBinding(0, 5, info), VK_SUCCESS);
+
+  Vulkan::Descriptors uab_desc(dev);
+  uab_desc.SetUpdateAfterBind(true);
+  EXPECT_EQ(uab_desc.AddSetLayoutConfig(conf), VK_SUCCESS);
+  EXPECT_EQ(uab_desc.BuildAllSetLayoutConfigs(), VK_SUCCESS);
+  EXPECT_EQ(uab_desc.UpdateBinding(0, 0, info), VK_SUCCESS);
+
+  Vulkan::DescriptorAllocator allocator(dev, Vulkan::DescriptorAllocatorConfig()
+                                        .AddPoolRatio(Vulkan::DescriptorType::BufferStorage, 2.0f)
+                                        .SetSetsPerPool(4)
+                                        .SetFramesCount(2));
+  EXPECT_EQ(allocator.IsValid(), true);
+  for (size_t frame = 0; frame < 4; ++frame)
+  {
+    EXPECT_EQ(allocator.BeginFrame(), VK_SUCCESS);
+    for (size_t i = 0; i < 16; ++i)
+    {
+      VkDescriptorSet set = VK_NULL_HANDLE;
+      EXPECT_EQ(allocator.Allocate(desc.GetDescriptorSetLayout(0), conf, set), VK_SUCCESS);
+      EXPECT_NE(set, (VkDescriptorSet) VK_NULL_HANDLE);
+    }
+    allocator.EndFrame();
+  }
+  EXPECT_EQ(allocator.GetPoolsCount(), (size_t) 6);
+  Vulkan::Fence frame_fence(dev, VK_FENCE_CREATE_SIGNALED_BIT);
+  EXPECT_EQ(allocator.BeginFrame(frame_fence.GetFence()), VK_SUCCESS);
+  EXPECT_EQ(allocator.GetPoolsCount(), (size_t) 6);
+
+  Vulkan::DescriptorSetCache set_cache(dev, Vulkan::DescriptorSetCacheConfig().SetCapacity(2).SetFramesInFlight(1));
+  VkDescriptorSet cached[2] = {};
+  EXPECT_EQ(set_cache.GetDescriptorSet(desc.GetDescriptorSetLayout(0), conf, cached[0]), VK_SUCCESS);
+  EXPECT_EQ(set_cache.GetDescriptorSet(desc.GetDescriptorSetLayout(0), conf, cached[1]), VK_SUCCESS);
+  EXPECT_EQ(cached[0], cached[1]);
+  EXPECT_EQ(set_cache.GetHitsCount(), (size_t) 1);
+  EXPECT_EQ(set_cache.GetSize(), (size_t) 1);
+
+  auto make_conf = [&array1, info] (const size_t first, const size_t second)
+  {
+    Vulkan::LayoutConfig result;
+    for (auto sub : { first, second })
+    {
+      auto sub_info = info;
+      sub_info.size = array1.GetInfo(0).sub_buffers[sub].size;
+      sub_info.offset = array1.GetInfo(0).sub_buffers[sub].offset;
+      sub_info.buffer_info.buffer_view = array1.GetInfo(0).sub_buffers[sub].view;
+      result.AddBufferOrImage(sub_info);
+    }
+    return result;
+  };
+  VkDescriptorSet swapped = VK_NULL_HANDLE, first_only = VK_NULL_HANDLE, second_only = VK_NULL_HANDLE;
+  EXPECT_EQ(set_cache.GetDescriptorSet(desc.GetDescriptorSetLayout(0), make_conf(1, 0), swapped), VK_SUCCESS);
+  EXPECT_EQ(set_cache.GetDescriptorSet(desc.GetDescriptorSetLayout(0), make_conf(0, 0), first_only), VK_SUCCESS);
+  EXPECT_EQ(set_cache.GetSize(), (size_t) 3);
+  EXPECT_NE(first_only, cached[0]);
+  set_cache.BeginFrame();
+  EXPECT_EQ(set_cache.GetDescriptorSet(desc.GetDescriptorSetLayout(0), make_conf(1, 1), second_only), VK_SUCCESS);
+  EXPECT_EQ(set_cache.GetSize(), (size_t) 2);
+  EXPECT_EQ(second_only, swapped);
+  EXPECT_EQ(set_cache.GetMissesCount(), (size_t) 4);
+  set_cache.Clear();
+  VkDescriptorSet after_clear = VK_NULL_HANDLE;
+  EXPECT_EQ(set_cache.GetDescriptorSet(desc.GetDescriptorSetLayout(0), make_conf(1, 1), after_clear), VK_SUCCESS);
+  EXPECT_NE(after_clear, second_only);
+
+  Vulkan::Descriptors dyn_desc(dev);
+  Vulkan::DescriptorInfo dyn_info = info;
+  dyn_info.type = info.MapStorageType(array1.GetInfo(0).type, true);
+  dyn_info.offset = 0;
+  dyn_info.size = array1.GetInfo(0).sub_buffers[0].size;
+  EXPECT_EQ(dyn_desc.AddSetLayoutConfig(Vulkan::LayoutConfig().AddBufferOrImage(dyn_info)), VK_SUCCESS);
+  EXPECT_EQ(dyn_desc.BuildAllSetLayoutConfigs(), VK_SUCCESS);
+  EXPECT_NE(dyn_desc.GetDescriptorSet(0), (VkDescriptorSet) VK_NULL_HANDLE);
+
+  Vulkan::Descriptors uab_dyn_desc(dev);
+  uab_dyn_desc.SetUpdateAfterBind(true);
+  EXPECT_EQ(uab_dyn_desc.AddSetLayoutConfig(Vulkan::LayoutConfig().AddBufferOrImage(info).AddBufferOrImage(dyn_info)), VK_SUCCESS);
+  EXPECT_EQ(uab_dyn_desc.BuildAllSetLayoutConfigs(), VK_SUCCESS);
+  EXPECT_NE(uab_dyn_desc.GetDescriptorSet(0), (VkDescriptorSet) VK_NULL_HANDLE);
+
+  Vulkan::ComputePipeline dyn_pipe(dev, Vulkan::ComputePipelineConfig()
+                              .AddDescriptorSetLayouts(dyn_desc.GetDescriptorSetLayouts())
+                              .SetShaderSource("#version 450\n"
+                                               "layout(local_size_x = 64) in;\n"
+                                               "layout(std430, binding = 0) buffer Data { float data[]; };\n"
+                                               "void main() { data[gl_GlobalInvocationID.x] *= 2.0; }\n"));
+  EXPECT_EQ(dyn_pipe.IsValid(), true);
+
+  Vulkan::CommandPool dyn_pool(dev, dev->GetComputeFamilyQueueIndex().value());
+  auto &dyn_cmd = dyn_pool.GetCommandBuffer(0, VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+  auto dyn_subs = array1.GetInfo(0).sub_buffers;
+  dyn_cmd.BeginCommandBuffer().BindPipeline(dyn_pipe);
+  for (auto &sub : dyn_subs)
+  {
+    dyn_cmd.BindDescriptorSets(dyn_pipe.GetLayout(), VK_PIPELINE_BIND_POINT_COMPUTE, {dyn_desc.GetDescriptorSet(0)}, 0, {(uint32_t) sub.offset})
+           .Dispatch((uint32_t) test_data1.size() / 64, 1, 1);
+  }
+  dyn_cmd.EndCommandBuffer();
+
+  if (Vulkan::Fence f(dev); f.IsValid())
+  {
+    EXPECT_EQ(dyn_pool.ExecuteBuffer(0, f.GetFence()), VK_SUCCESS);
+    EXPECT_EQ(f.Wait(), VK_SUCCESS);
+  }
+
+  std::vector<float> dyn_result(test_data1.size(), 0.0f);
+  EXPECT_EQ(array1.GetSubBufferData(0, 0, dyn_result), VK_SUCCESS);
+  EXPECT_EQ(dyn_result, std::vector<float>(test_data1.size(), 10.0f));
+  EXPECT_EQ(array1.GetSubBufferData(0, 1, dyn_result), VK_SUCCESS);
+  EXPECT_EQ(dyn_result, std::vector<float>(test_data2.size(), 12.0f));
 
   Vulkan::Descriptors desc1(desc);
+  EXPECT_EQ(desc1.GetDescriptorSetLayout(0), desc.GetDescriptorSetLayout(0));
 
   EXPECT_EQ(desc1.AddSetLayoutConfig(conf), VK_SUCCESS);
   EXPECT_EQ(desc1.BuildAllSetLayoutConfigs(), VK_SUCCESS);
@@ -122,7 +249,8 @@ TEST (Vulkan, ComputePipeline)
 {
   std::shared_ptr<Vulkan::Device> dev = std::make_shared<Vulkan::Device>(Vulkan::DeviceConfig()
                                           .SetDeviceType(Vulkan::PhysicalDeviceType::Discrete)
-                                          .SetQueueType(Vulkan::QueueType::ComputeType));
+                                          .SetQueueType(Vulkan::QueueType::ComputeType)
+                                          .SetPipelineCacheDirectory("pipeline_cache"));
   std::vector<float> input(256, 5.0);
   UniformData udata = {};
   udata.mul = 3;
@@ -135,6 +263,49 @@ TEST (Vulkan, ComputePipeline)
   EXPECT_EQ(array1.SetSubBufferData(0, 0, input), VK_SUCCESS);
   EXPECT_EQ(array1.SetBufferData<UniformData>(1, { udata }), VK_SUCCESS);
 
+  if (Vulkan::BindlessDescriptors::IsSupported(dev))
+  {
+    Vulkan::BindlessDescriptors bindless(dev, Vulkan::BindlessConfig().SetDescriptorsCount(Vulkan::BindlessType::StorageBuffer, 1024));
+    EXPECT_EQ(bindless.IsValid(), true);
+    EXPECT_EQ(bindless.AddSubBuffer(array1, 0, 0).value_or(UINT32_MAX), (uint32_t) 0);
+    EXPECT_EQ(bindless.AddSubBuffer(array1, 0, 1).value_or(UINT32_MAX), (uint32_t) 1);
+    bindless.Remove(Vulkan::BindlessType::StorageBuffer, 0);
+    EXPECT_EQ(bindless.AddSubBuffer(array1, 0, 1).value_or(UINT32_MAX), (uint32_t) 2);
+    bindless.BeginFrame();
+    bindless.BeginFrame();
+    EXPECT_EQ(bindless.AddSubBuffer(array1, 0, 0).value_or(UINT32_MAX), (uint32_t) 0);
+
+    Vulkan::ComputePipeline bindless_pipe(dev, Vulkan::ComputePipelineConfig()
+                              .AddDescriptorSetLayout(bindless.GetDescriptorSetLayout())
+                              .SetShaderSource("#version 450\n"
+                                               "#extension GL_EXT_nonuniform_qualifier : require\n"
+                                               "layout(local_size_x = 64) in;\n"
+                                               "layout(std430, binding = 0) buffer Buffers { float data[]; } buffers[];\n"
+                                               "layout(push_constant) uniform Params { uint src; uint dst; } p;\n"
+                                               "void main() { uint i = gl_GlobalInvocationID.x; buffers[p.dst].data[i] = buffers[p.src].data[i] * 2.0; }\n"));
+    EXPECT_EQ(bindless_pipe.IsValid(), true);
+
+    std::array<uint32_t, 2> indices = { 0, 1 };
+    Vulkan::CommandPool bindless_pool(dev, dev->GetComputeFamilyQueueIndex().value());
+    bindless_pool.GetCommandBuffer(0, VK_COMMAND_BUFFER_LEVEL_PRIMARY)
+        .BeginCommandBuffer()
+        .BindPipeline(bindless_pipe)
+        .BindDescriptorSets(bindless_pipe.GetLayout(), VK_PIPELINE_BIND_POINT_COMPUTE, {bindless.GetDescriptorSet()}, 0, {})
+        .PushConstants(bindless_pipe.GetLayout(), VK_SHADER_STAGE_COMPUTE_BIT, indices)
+        .Dispatch((uint32_t) input.size() / 64, 1, 1)
+        .EndCommandBuffer();
+
+    if (Vulkan::Fence f(dev); f.IsValid())
+    {
+      EXPECT_EQ(bindless_pool.ExecuteBuffer(0, f.GetFence()), VK_SUCCESS);
+      EXPECT_EQ(f.Wait(), VK_SUCCESS);
+    }
+
+    std::vector<float> doubled(input.size(), 0.0f);
+    EXPECT_EQ(array1.GetSubBufferData(0, 1, doubled), VK_SUCCESS);
+    EXPECT_EQ(doubled, std::vector<float>(input.size(), 10.0f));
+  }
+
   Vulkan::Descriptors desc(dev);
   Vulkan::DescriptorInfo d_info = {};
   d_info.buffer_info.buffer = array1.GetInfo(0).buffer;
@@ -153,7 +324,11 @@ TEST (Vulkan, ComputePipeline)
   d_info.offset = 0;
   d_info.type = d_info.MapStorageType(array1.GetInfo(1).type);
   d_info.buffer_info.buffer = array1.GetInfo(1).buffer;
-  EXPECT_EQ(desc.AddSetLayoutConfig(Vulkan::LayoutConfig().AddBufferOrImage(d_info)), VK_SUCCESS);
+  Vulkan::ShaderReflection reflection(Vulkan::Misc::LoadShaderFromFile("test.comp.spv"));
+  EXPECT_EQ(reflection.GetSetsCount(), (uint32_t) 3);
+  EXPECT_EQ(reflection.GetBindings(2).size(), (size_t) 1);
+  EXPECT_EQ(reflection.GetBindings(2)[0].type, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
+  EXPECT_EQ(desc.AddSetLayoutConfig(Vulkan::LayoutConfig().AddBufferOrImage(d_info), reflection, 2), VK_SUCCESS);
 
   EXPECT_EQ(desc.BuildAllSetLayoutConfigs(), VK_SUCCESS);
 
@@ -168,10 +343,78 @@ TEST (Vulkan, ComputePipeline)
                               .AddDescriptorSetLayouts(desc.GetDescriptorSetLayouts()));
 
   EXPECT_NE(c_pipe.GetPipeline(), (VkPipeline) VK_NULL_HANDLE);
+  EXPECT_EQ(dev->GetShaderModulesCount(), (size_t) 1);
   EXPECT_NE(pipelines.GetPipeline(0), (VkPipeline) VK_NULL_HANDLE);
   EXPECT_EQ(pipelines.AddPipeline(std::move(c_pipe)), VK_SUCCESS);
   EXPECT_NE(pipelines.GetPipeline(1), (VkPipeline) VK_NULL_HANDLE);
 
+  std::vector<size_t> batch_indices;
+  std::vector<Vulkan::ComputePipelineConfig> batch(4, Vulkan::ComputePipelineConfig()
+                              .SetShader("test.comp.spv", "main")
+                              .AddDescriptorSetLayouts(desc.GetDescriptorSetLayouts()));
+  EXPECT_EQ(pipelines.AddPipelines(dev, batch, batch_indices), VK_SUCCESS);
+  EXPECT_EQ(batch_indices.size(), batch.size());
+  for (auto i : batch_indices)
+    EXPECT_NE(pipelines.GetPipeline(i), (VkPipeline) VK_NULL_HANDLE);
+
+  Vulkan::ComputePipeline scaled(dev, Vulkan::ComputePipelineConfig()
+                              .SetShader("test.comp.spv", "main")
+                              .SetSpecializationConstant(0, (uint32_t) 2)
+                              .AddDescriptorSetLayouts(desc.GetDescriptorSetLayouts()));
+  EXPECT_EQ(scaled.IsValid(), true);
+  EXPECT_NE(scaled.GetPipeline(), pipelines.GetPipeline(0));
+
+  Vulkan::CommandPool scaled_pool(dev, dev->GetComputeFamilyQueueIndex().value());
+  scaled_pool.GetCommandBuffer(0, VK_COMMAND_BUFFER_LEVEL_PRIMARY)
+      .BeginCommandBuffer()
+      .BindPipeline(scaled)
+      .BindDescriptorSets(scaled.GetLayout(), VK_PIPELINE_BIND_POINT_COMPUTE, desc.GetDescriptorSets(), 0, {})
+      .Dispatch((uint32_t) input.size() / scaled.GetWorkgroupSize().x, 1, 1)
+      .EndCommandBuffer();
+
+  if (Vulkan::Fence f(dev); f.IsValid())
+  {
+    EXPECT_EQ(scaled_pool.ExecuteBuffer(0, f.GetFence()), VK_SUCCESS);
+    EXPECT_EQ(f.Wait(), VK_SUCCESS);
+  }
+
+  std::vector<float> scaled_output(input.size(), 0.0f);
+  EXPECT_EQ(array1.GetSubBufferData(0, 1, scaled_output), VK_SUCCESS);
+  EXPECT_EQ(scaled_output, std::vector<float>(input.size(), input[0] * udata.mul * 2));
+
+  Vulkan::ComputePipeline generated(dev, Vulkan::ComputePipelineConfig()
+                              .SetShaderSource("#version 450\nlayout(local_size_x = WG) in;\nvoid main() {}\n", { { "WG", "32" } }));
+  EXPECT_EQ(generated.IsValid(), true);
+  EXPECT_EQ(generated.GetWorkgroupSize().x, (uint32_t) 32);
+
+  auto tuned_config = Vulkan::ComputePipelineConfig()
+                              .SetShaderSource("#version 450\nlayout(local_size_x_id = 1) in;\nvoid main() {}\n")
+                              .SetAutotune("empty_kernel", 1);
+  EXPECT_EQ(Vulkan::Autotuner::Tune(dev, Vulkan::AutotuneConfig()
+                              .SetPipelineConfig(tuned_config)
+                              .AddCandidate({ 32, 1, 1 })
+                              .AddCandidate({ 64, 1, 1 })
+                              .SetThreads(1 << 16)
+                              .SetRepeats(3)
+                              .Retune(true)), VK_SUCCESS);
+  EXPECT_EQ(dev->GetTunedWorkgroupSize("empty_kernel").has_value(), true);
+  EXPECT_EQ(Vulkan::ComputePipeline(dev, tuned_config).GetWorkgroupSize().x, dev->GetTunedWorkgroupSize("empty_kernel")->x);
+  {
+    Vulkan::Device reloaded(Vulkan::DeviceConfig()
+                              .SetDeviceType(Vulkan::PhysicalDeviceType::Discrete)
+                              .SetQueueType(Vulkan::QueueType::ComputeType)
+                              .SetPipelineCacheDirectory("pipeline_cache"));
+    EXPECT_EQ(std::filesystem::exists(std::filesystem::path("pipeline_cache") / ("autotune_" + reloaded.GetDeviceUUID() + ".txt")), true);
+    EXPECT_EQ(reloaded.GetTunedWorkgroupSize("empty_kernel").has_value(), true);
+    EXPECT_EQ(reloaded.GetTunedWorkgroupSize("empty_kernel")->x, dev->GetTunedWorkgroupSize("empty_kernel")->x);
+  }
+
+  Vulkan::ComputePipeline embedded(dev, Vulkan::ComputePipelineConfig()
+                              .SetEmbeddedShader("test.comp")
+                              .AddDescriptorSetLayouts(desc.GetDescriptorSetLayouts()));
+  EXPECT_EQ(embedded.IsValid(), true);
+  EXPECT_EQ(embedded.GetWorkgroupSize().x, (uint32_t) 64);
+
   Vulkan::Pipelines pipelines2(std::move(pipelines));
 
   EXPECT_EQ(c_pipe.IsValid(), false);
@@ -179,12 +422,38 @@ TEST (Vulkan, ComputePipeline)
   Vulkan::CommandPool pool(dev, dev->GetComputeFamilyQueueIndex().value());
   pool.GetCommandBuffer(0, VK_COMMAND_BUFFER_LEVEL_PRIMARY)
       .BeginCommandBuffer()
-      .BindPipeline(pipelines2.GetPipeline(1), VK_PIPELINE_BIND_POINT_COMPUTE)
+      .BindPipeline(pipelines2.GetHandle(1))
       .BindDescriptorSets(pipelines2.GetLayout(1), VK_PIPELINE_BIND_POINT_COMPUTE, desc.GetDescriptorSets(), 0, {})
-      .Dispatch(256, 1, 1)
+      .DispatchThreads(256, 1, 1)
       .EndCommandBuffer();
 
   EXPECT_EQ(pool.IsReady(0), true);
+  EXPECT_EQ(pipelines2.GetWorkgroupSize(1).x, (uint32_t) 64);
+  EXPECT_EQ(pipelines2.GetPipelinesCount(), batch.size() + 2);
+  EXPECT_EQ(pipelines2.GetHandle(1).bind_point, VK_PIPELINE_BIND_POINT_COMPUTE);
+#ifdef __linux__
+  EXPECT_EQ(pipelines2.EnableHotReload(), VK_SUCCESS);
+  EXPECT_EQ(pipelines2.IsHotReloadEnabled(), true);
+  if (Vulkan::Fence f(dev, VK_FENCE_CREATE_SIGNALED_BIT); f.IsValid())
+  {
+    EXPECT_EQ(pipelines2.CommitReloads(f.GetFence()), (size_t) 0);
+
+    auto reloaded = batch.size() + 1;
+    auto old_pipeline = pipelines2.GetPipeline(0);
+    auto spv = Vulkan::Misc::LoadShaderFromFile("test.comp.spv");
+    std::ofstream("test.comp.spv", std::ios::binary | std::ios::trunc).write(spv.data(), spv.size());
+    for (size_t i = 0; i < 100 && pipelines2.GetPendingReloadsCount() < reloaded; ++i)
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    EXPECT_EQ(pipelines2.CommitReloads(f.GetFence()), reloaded);
+    EXPECT_NE(pipelines2.GetPipeline(0), old_pipeline);
+    EXPECT_NE(pipelines2.GetPipeline(0), (VkPipeline) VK_NULL_HANDLE);
+    EXPECT_EQ(pipelines2.GetRetiredCount(), reloaded);
+    EXPECT_EQ(pipelines2.CollectRetired(), reloaded);
+    EXPECT_EQ(pipelines2.GetRetiredCount(), (size_t) 0);
+  }
+  pipelines2.DisableHotReload();
+#endif
 
   if (Vulkan::Fence f(dev); f.IsValid())
   {
@@ -200,8 +469,179 @@ TEST (Vulkan, ComputePipeline)
       EXPECT_EQ(pool.ExecuteBuffer(0, ptr->GetFence()), VK_SUCCESS);
       EXPECT_EQ(f.WaitFor(), VK_SUCCESS);
     }
+
+    VkFence recycled = f[0];
+    f.Clear();
+    EXPECT_EQ(f.Add(), VK_SUCCESS);
+    EXPECT_EQ(f[0], recycled);
+    EXPECT_EQ(f.GetFence(0)->GetState().value_or((VkBool32) VK_SUCCESS), (VkBool32) VK_NOT_READY);
+  }
+
+  {
+    VkFence signaled = VK_NULL_HANDLE;
+    if (Vulkan::Fence f(dev, VK_FENCE_CREATE_SIGNALED_BIT); f.IsValid())
+      signaled = f.GetFence();
+    Vulkan::Fence unsignaled(dev);
+    EXPECT_NE(unsignaled.GetFence(), signaled);
+    Vulkan::Fence f(dev, VK_FENCE_CREATE_SIGNALED_BIT);
+    EXPECT_EQ(f.GetFence(), signaled);
+    EXPECT_EQ(f.GetState().value_or((VkBool32) VK_NOT_READY), (VkBool32) VK_SUCCESS);
+  }
+
+  if (Vulkan::TimelineSemaphore t(dev); t.IsValid())
+  {
+    EXPECT_EQ(pool.ExecuteBuffer(0, VK_NULL_HANDLE, { t.GetSemaphore() }, {}, {}, { 1 }), VK_SUCCESS);
+    EXPECT_EQ(t.Wait(1), VK_SUCCESS);
+    EXPECT_EQ(t.GetValue().value_or(0), (uint64_t) 1);
+    EXPECT_EQ(t.Signal(5), VK_SUCCESS);
+    EXPECT_EQ(t.GetValue().value_or(0), (uint64_t) 5);
+  }
+
+  Vulkan::StorageArray indirect(dev);
+  std::vector<VkDispatchIndirectCommand> dispatch_args = { { 256 / pipelines2.GetWorkgroupSize(1).x, 1, 1 } };
+  EXPECT_EQ(indirect.StartConfig(Vulkan::HostVisibleMemory::HostVisible), VK_SUCCESS);
+  EXPECT_EQ(indirect.AddBuffer(Vulkan::BufferConfig()
+                  .SetType(Vulkan::StorageType::Indirect)
+                  .AddSubBuffer(dispatch_args)), VK_SUCCESS);
+  EXPECT_EQ(indirect.EndConfig(), VK_SUCCESS);
+  EXPECT_EQ(indirect.SetSubBufferData(0, 0, dispatch_args), VK_SUCCESS);
+
+  pool.GetCommandBuffer(1, VK_COMMAND_BUFFER_LEVEL_PRIMARY)
+      .BeginCommandBuffer()
+      .BindPipeline(pipelines2.GetPipeline(1), VK_PIPELINE_BIND_POINT_COMPUTE)
+      .BindDescriptorSets(pipelines2.GetLayout(1), VK_PIPELINE_BIND_POINT_COMPUTE, desc.GetDescriptorSets(), 0, {})
+      .DispatchIndirect(indirect, 0, 0)
+      .EndCommandBuffer();
+
+  if (Vulkan::Fence f(dev); f.IsValid())
+  {
+    EXPECT_EQ(pool.ExecuteBuffer(1, f.GetFence()), VK_SUCCESS);
+    EXPECT_EQ(f.Wait(), VK_SUCCESS);
+  }
+
+  Vulkan::FrameCommandPools frames(dev, dev->GetComputeFamilyQueueIndex().value(), 2);
+  EXPECT_EQ(frames.IsValid(), true);
+  for (size_t i = 0; i < 4; ++i)
+  {
+    EXPECT_EQ(frames.BeginFrame(), VK_SUCCESS);
+    for (size_t j = 0; j < 2; ++j)
+    {
+      auto &frame_cmd = frames.NextCommandBuffer();
+      frame_cmd.BeginCommandBuffer(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT)
+          .BindPipeline(pipelines2.GetPipeline(1), VK_PIPELINE_BIND_POINT_COMPUTE)
+          .BindDescriptorSets(pipelines2.GetLayout(1), VK_PIPELINE_BIND_POINT_COMPUTE, desc.GetDescriptorSets(), 0, {})
+          .SetWorkgroupSize(pipelines2.GetWorkgroupSize(1))
+          .DispatchThreads(256, 1, 1)
+          .EndCommandBuffer();
+      EXPECT_EQ(frames.ExecuteBuffer(frame_cmd), VK_SUCCESS);
+    }
+    EXPECT_EQ(frames.EndFrame(), VK_SUCCESS);
+  }
+
+  auto transfer_family = dev->GetTransferFamilyQueueIndex();
+  EXPECT_TRUE(transfer_family.has_value());
+  if (transfer_family.has_value())
+  {
+    const VkQueueFlags universal = VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT;
+    auto transfer_flags = dev->GetFamilyQueueProperties(transfer_family.value()).queueFlags;
+    EXPECT_NE(transfer_flags & (universal | VK_QUEUE_TRANSFER_BIT), (VkQueueFlags) 0);
+    EXPECT_GT(dev->GetFamilyQueuesCount(transfer_family.value()), (uint32_t) 0);
+
+    uint32_t families_count = 0;
+    bool has_dedicated = false;
+    vkGetPhysicalDeviceQueueFamilyProperties(dev->GetPhysicalDevice(), &families_count, nullptr);
+    for (uint32_t i = 0; i < families_count; ++i)
+    {
+      auto flags = dev->GetFamilyQueueProperties(i).queueFlags;
+      has_dedicated |= (flags & VK_QUEUE_TRANSFER_BIT) && !(flags & universal);
+    }
+    EXPECT_EQ(dev->HasDedicatedQueue(Vulkan::QueuePurpose::TransferPurpose), has_dedicated);
+    if (has_dedicated)
+      EXPECT_EQ(transfer_flags & universal, (VkQueueFlags) 0);
+
+    std::vector<float> doubled_input(input.size(), input[0] * 2);
+    Vulkan::StorageArray upload(dev);
+    EXPECT_EQ(upload.StartConfig(Vulkan::HostVisibleMemory::HostVisible), VK_SUCCESS);
+    EXPECT_EQ(upload.AddBuffer(Vulkan::BufferConfig().AddSubBuffer(doubled_input)), VK_SUCCESS);
+    EXPECT_EQ(upload.EndConfig(), VK_SUCCESS);
+    EXPECT_EQ(upload.SetSubBufferData(0, 0, doubled_input), VK_SUCCESS);
+
+    auto src = Vulkan::BufferRange::FromSubBuffer(upload, 0, 0);
+    auto dst = Vulkan::BufferRange::FromSubBuffer(array1, 0, 0);
+    auto compute_family = dev->GetComputeFamilyQueueIndex().value();
+    VkBufferMemoryBarrier ownership = {};
+    ownership.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    ownership.srcQueueFamilyIndex = transfer_family.value();
+    ownership.dstQueueFamilyIndex = compute_family;
+    ownership.buffer = dst.buffer;
+    ownership.offset = dst.offset;
+    ownership.size = dst.size;
+
+    Vulkan::CommandPool transfer_pool(dev, transfer_family.value());
+    auto &copy_cmd = transfer_pool.GetCommandBuffer(0, VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+    copy_cmd.BeginCommandBuffer().CopyBufferToBuffer(src.buffer, dst.buffer, { { src.offset, dst.offset, src.size } });
+    if (transfer_family.value() != compute_family)
+    {
+      ownership.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+      vkCmdPipelineBarrier(copy_cmd.GetBuffer(), VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 1, &ownership, 0, nullptr);
+    }
+    copy_cmd.EndCommandBuffer();
+
+    Vulkan::CommandPool compute_pool(dev, compute_family);
+    auto &compute_cmd = compute_pool.GetCommandBuffer(0, VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+    compute_cmd.BeginCommandBuffer();
+    if (transfer_family.value() != compute_family)
+    {
+      ownership.srcAccessMask = 0;
+      ownership.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+      vkCmdPipelineBarrier(compute_cmd.GetBuffer(), VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 1, &ownership, 0, nullptr);
+    }
+    compute_cmd.BindPipeline(pipelines2.GetPipeline(1), VK_PIPELINE_BIND_POINT_COMPUTE)
+        .BindDescriptorSets(pipelines2.GetLayout(1), VK_PIPELINE_BIND_POINT_COMPUTE, desc.GetDescriptorSets(), 0, {})
+        .SetWorkgroupSize(pipelines2.GetWorkgroupSize(1))
+        .DispatchThreads(256, 1, 1)
+        .EndCommandBuffer();
+
+    Vulkan::Semaphore copied(dev);
+    Vulkan::Fence f(dev);
+    EXPECT_EQ(transfer_pool.ExecuteBuffer(0, VK_NULL_HANDLE, { copied.GetSemaphore() }), VK_SUCCESS);
+    EXPECT_EQ(compute_pool.ExecuteBuffer(0, f.GetFence(), {}, { VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT }, { copied.GetSemaphore() }), VK_SUCCESS);
+    EXPECT_EQ(f.Wait(), VK_SUCCESS);
+    copied.MarkWaited();
+
+    std::vector<float> transferred(input.size(), 0.0f);
+    EXPECT_EQ(array1.GetSubBufferData(0, 1, transferred), VK_SUCCESS);
+    EXPECT_EQ(transferred, std::vector<float>(input.size(), doubled_input[0] * udata.mul));
+
+    VkSemaphore waited = copied.GetSemaphore();
+    {
+      Vulkan::Semaphore released(std::move(copied));
+    }
+    Vulkan::Semaphore recycled(dev);
+    EXPECT_EQ(recycled.GetSemaphore(), waited);
+  }
+
+  if (auto family = dev->GetAsyncComputeFamilyQueueIndex(); family.has_value())
+  {
+    Vulkan::CommandPool async_pool(dev, family.value());
+    async_pool.GetCommandBuffer(0, VK_COMMAND_BUFFER_LEVEL_PRIMARY)
+        .BeginCommandBuffer()
+        .BindPipeline(pipelines2.GetPipeline(1), VK_PIPELINE_BIND_POINT_COMPUTE)
+        .BindDescriptorSets(pipelines2.GetLayout(1), VK_PIPELINE_BIND_POINT_COMPUTE, desc.GetDescriptorSets(), 0, {})
+        .SetWorkgroupSize(pipelines2.GetWorkgroupSize(1))
+        .DispatchThreads(256, 1, 1)
+        .EndCommandBuffer();
+
+    if (Vulkan::Fence f(dev); f.IsValid())
+    {
+      EXPECT_EQ(async_pool.ExecuteBuffer(0, f.GetFence()), VK_SUCCESS);
+      EXPECT_EQ(f.Wait(), VK_SUCCESS);
+    }
   }
 
+  EXPECT_NE(dev->GetPipelineCache(), (VkPipelineCache) VK_NULL_HANDLE);
+  EXPECT_EQ(dev->SavePipelineCache(), VK_SUCCESS);
+
   std::vector<float> output(256, 0.0);
   EXPECT_EQ(array1.GetSubBufferData(0, 1, output), VK_SUCCESS);
 
@@ -213,6 +653,361 @@ TEST (Vulkan, ComputePipeline)
   std::cout << std::endl;
 }
 
+TEST (Vulkan, Primitives)
+{
+  std::shared_ptr<Vulkan::Device> dev = std::make_shared<Vulkan::Device>(Vulkan::DeviceConfig()
+                                          .SetDeviceType(Vulkan::PhysicalDeviceType::Discrete)
+                                          .SetQueueType(Vulkan::QueueType::ComputeType));
+  const uint32_t n = 10000;
+  std::vector<uint32_t> input(n), flags(n), values(n);
+  uint32_t seed = 12345;
+  for (uint32_t i = 0; i < n; ++i)
+  {
+    seed = seed * 1664525u + 1013904223u;
+    input[i] = seed;
+    flags[i] = (seed >> 8) % 3 == 0;
+    values[i] = i;
+  }
+
+  Vulkan::StorageArray array(dev);
+  EXPECT_EQ(array.StartConfig(Vulkan::HostVisibleMemory::HostVisible), VK_SUCCESS);
+  EXPECT_EQ(array.AddBuffer(Vulkan::BufferConfig()
+                  .AddSubBuffer(n, sizeof(uint32_t))
+                  .AddSubBufferRange(3, 1, sizeof(uint32_t))
+                  .AddSubBufferRange(4, n, sizeof(uint32_t))
+                  .AddSubBuffer(1, sizeof(uint32_t))
+                  .AddSubBufferRange(2, n, sizeof(uint32_t))
+                  .AddSubBuffer(n, sizeof(float))
+                  .AddSubBuffer(1, sizeof(float))), VK_SUCCESS);
+  EXPECT_EQ(array.EndConfig(), VK_SUCCESS);
+  std::vector<float> float_input(n);
+  for (uint32_t i = 0; i < n; ++i)
+    float_input[i] = (float) (input[i] % 100) * 0.25f - 10.0f;
+  EXPECT_EQ(array.SetSubBufferData(0, 0, input), VK_SUCCESS);
+  EXPECT_EQ(array.SetSubBufferData(0, 6, flags), VK_SUCCESS);
+  EXPECT_EQ(array.SetSubBufferData(0, 11, float_input), VK_SUCCESS);
+  EXPECT_EQ(array.SetSubBufferData(0, 9, input), VK_SUCCESS);
+  EXPECT_EQ(array.SetSubBufferData(0, 10, values), VK_SUCCESS);
+
+  Vulkan::Primitives prims(dev, Vulkan::PrimitivesConfig().SetMaxElements(n));
+  EXPECT_EQ(prims.IsValid(), true);
+  auto range = [&array] (const size_t i) { return Vulkan::BufferRange::FromSubBuffer(array, 0, i); };
+
+  Vulkan::CommandPool pool(dev, dev->GetComputeFamilyQueueIndex().value());
+  auto &cmd = pool.GetCommandBuffer(0, VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+  cmd.BeginCommandBuffer();
+  EXPECT_EQ(prims.Reduce(cmd, range(0), range(1), n), VK_SUCCESS);
+  EXPECT_EQ(prims.Reduce(cmd, range(0), range(2), n, Vulkan::ReduceOp::Min, Vulkan::ElementType::Int), VK_SUCCESS);
+  EXPECT_EQ(prims.Reduce(cmd, range(0), range(3), n, Vulkan::ReduceOp::Max, Vulkan::ElementType::Uint), VK_SUCCESS);
+  EXPECT_EQ(prims.ExclusiveScan(cmd, range(0), range(4), n), VK_SUCCESS);
+  EXPECT_EQ(prims.InclusiveScan(cmd, range(0), range(5), n), VK_SUCCESS);
+  EXPECT_EQ(prims.Compact(cmd, range(0), range(6), range(7), range(8), n), VK_SUCCESS);
+  EXPECT_EQ(prims.RadixSort(cmd, range(9), n, range(10)), VK_SUCCESS);
+  EXPECT_EQ(prims.Reduce(cmd, range(11), range(12), n, Vulkan::ReduceOp::Add, Vulkan::ElementType::Float), VK_SUCCESS);
+  cmd.EndCommandBuffer();
+
+  if (Vulkan::Fence f(dev); f.IsValid())
+  {
+    EXPECT_EQ(pool.ExecuteBuffer(0, f.GetFence()), VK_SUCCESS);
+    EXPECT_EQ(f.Wait(), VK_SUCCESS);
+  }
+
+  std::vector<uint32_t> result(1);
+  EXPECT_EQ(array.GetSubBufferData(0, 1, result), VK_SUCCESS);
+  EXPECT_EQ(result[0], std::accumulate(input.begin(), input.end(), 0u));
+  EXPECT_EQ(array.GetSubBufferData(0, 2, result), VK_SUCCESS);
+  EXPECT_EQ((int32_t) result[0], (int32_t) *std::min_element(input.begin(), input.end(), [] (auto a, auto b) { return (int32_t) a < (int32_t) b; }));
+  EXPECT_EQ(array.GetSubBufferData(0, 3, result), VK_SUCCESS);
+  EXPECT_EQ(result[0], *std::max_element(input.begin(), input.end()));
+  std::vector<float> float_result(1);
+  EXPECT_EQ(array.GetSubBufferData(0, 12, float_result), VK_SUCCESS);
+  EXPECT_FLOAT_EQ(float_result[0], std::accumulate(float_input.begin(), float_input.end(), 0.0f));
+
+  std::vector<uint32_t> expected(n);
+  result.resize(n);
+  std::exclusive_scan(input.begin(), input.end(), expected.begin(), 0u);
+  EXPECT_EQ(array.GetSubBufferData(0, 4, result), VK_SUCCESS);
+  EXPECT_EQ(result, expected);
+  std::inclusive_scan(input.begin(), input.end(), expected.begin());
+  EXPECT_EQ(array.GetSubBufferData(0, 5, result), VK_SUCCESS);
+  EXPECT_EQ(result, expected);
+
+  expected.clear();
+  for (uint32_t i = 0; i < n; ++i)
+    if (flags[i] != 0) expected.push_back(input[i]);
+  EXPECT_EQ(array.GetSubBufferData(0, 7, result), VK_SUCCESS);
+  result.resize(expected.size());
+  EXPECT_EQ(result, expected);
+  std::vector<uint32_t> count(1);
+  EXPECT_EQ(array.GetSubBufferData(0, 8, count), VK_SUCCESS);
+  EXPECT_EQ(count[0], (uint32_t) expected.size());
+
+  std::stable_sort(values.begin(), values.end(), [&input] (auto a, auto b) { return input[a] < input[b]; });
+  expected.resize(n);
+  std::transform(values.begin(), values.end(), expected.begin(), [&input] (auto i) { return input[i]; });
+  result.resize(n);
+  EXPECT_EQ(array.GetSubBufferData(0, 9, result), VK_SUCCESS);
+  EXPECT_EQ(result, expected);
+  EXPECT_EQ(array.GetSubBufferData(0, 10, result), VK_SUCCESS);
+  EXPECT_EQ(result, values);
+}
+
+TEST (Vulkan, PrimitivesBenchmark)
+{
+  std::shared_ptr<Vulkan::Device> dev = std::make_shared<Vulkan::Device>(Vulkan::DeviceConfig()
+                                          .SetDeviceType(Vulkan::PhysicalDeviceType::Discrete)
+                                          .SetQueueType(Vulkan::QueueType::ComputeType));
+  const uint32_t n = 1 << 22;
+  std::vector<uint32_t> input(n);
+  uint32_t seed = 1;
+  for (auto &v : input)
+    v = seed = seed * 1664525u + 1013904223u;
+
+  Vulkan::StorageArray staging(dev);
+  EXPECT_EQ(staging.StartConfig(Vulkan::HostVisibleMemory::HostVisible), VK_SUCCESS);
+  EXPECT_EQ(staging.AddBuffer(Vulkan::BufferConfig().AddSubBuffer(n, sizeof(uint32_t))), VK_SUCCESS);
+  EXPECT_EQ(staging.EndConfig(), VK_SUCCESS);
+  EXPECT_EQ(staging.SetSubBufferData(0, 0, input), VK_SUCCESS);
+
+  Vulkan::StorageArray array(dev);
+  EXPECT_EQ(array.StartConfig(Vulkan::HostVisibleMemory::HostInvisible), VK_SUCCESS);
+  EXPECT_EQ(array.AddBuffer(Vulkan::BufferConfig().AddSubBufferRange(2, n, sizeof(uint32_t))), VK_SUCCESS);
+  EXPECT_EQ(array.EndConfig(), VK_SUCCESS);
+
+  Vulkan::Primitives prims(dev, Vulkan::PrimitivesConfig().SetMaxElements(n));
+  EXPECT_EQ(prims.IsValid(), true);
+  auto src = Vulkan::BufferRange::FromSubBuffer(staging, 0, 0);
+  auto in = Vulkan::BufferRange::FromSubBuffer(array, 0, 0);
+  auto out = Vulkan::BufferRange::FromSubBuffer(array, 0, 1);
+  auto family = dev->GetComputeFamilyQueueIndex().value();
+  Vulkan::CommandPool pool(dev, family);
+  Vulkan::TimestampQueryPool queries(dev, 2, family);
+
+  auto &upload = pool.GetCommandBuffer(0, VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+  upload.BeginCommandBuffer().CopyBufferToBuffer(src.buffer, in.buffer, { { src.offset, in.offset, src.size } }).EndCommandBuffer();
+  if (Vulkan::Fence f(dev); f.IsValid())
+  {
+    EXPECT_EQ(pool.ExecuteBuffer(0, f.GetFence()), VK_SUCCESS);
+    EXPECT_EQ(f.Wait(), VK_SUCCESS);
+  }
+
+  auto measure = [&] (const std::string &name, auto record, const double amount, const std::string &unit)
+  {
+    double best = 0.0;
+    for (size_t i = 0; i < 4; ++i)
+    {
+      prims.BeginFrame();
+      auto &cmd = pool.GetCommandBuffer(0, VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+      cmd.BeginCommandBuffer();
+      if (queries.IsValid())
+        cmd.ResetQueryPool(queries.GetQueryPool(), 0, 2).WriteTimestamp(queries.GetQueryPool(), 0, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+      EXPECT_EQ(record(cmd), VK_SUCCESS);
+      if (queries.IsValid())
+        cmd.WriteTimestamp(queries.GetQueryPool(), 1, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+      cmd.EndCommandBuffer();
+
+      Vulkan::Fence f(dev);
+      auto start = std::chrono::steady_clock::now();
+      EXPECT_EQ(pool.ExecuteBuffer(0, f.GetFence()), VK_SUCCESS);
+      EXPECT_EQ(f.Wait(), VK_SUCCESS);
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      double seconds = queries.IsValid() ? queries.GetElapsed(0, 1).value_or(0.0) * 1e-9 : elapsed.count();
+      if (i > 0 && seconds > 0.0)
+        best = std::max(best, amount / seconds);
+    }
+    std::cout << name << ": " << best << " " << unit << (prims.IsSubgroupEnabled() ? " (subgroups)" : "") << std::endl;
+  };
+
+  const double bytes = (double) n * sizeof(uint32_t) / 1e9;
+  measure("Reduce", [&] (auto &cmd) { return prims.Reduce(cmd, in, out, n); }, bytes, "GB/s");
+  measure("ExclusiveScan", [&] (auto &cmd) { return prims.ExclusiveScan(cmd, in, out, n); }, bytes * 2, "GB/s");
+  measure("RadixSort", [&] (auto &cmd)
+  {
+    cmd.CopyBufferToBuffer(in.buffer, out.buffer, { { in.offset, out.offset, in.size } });
+    return prims.RadixSort(cmd, out, n);
+  }, (double) n / 1e6, "Mkeys/s");
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC push_options
+#pragma GCC optimize("O3")
+#endif
+static void CpuGemm(const std::vector<float> &a, const std::vector<float> &b, std::vector<float> &c, const Vulkan::GemmShape &s, const float alpha, const float beta)
+{
+  const float *pa = a.data(), *pb = b.data();
+  float *pc = c.data();
+  #pragma omp parallel for
+  for (uint32_t i = 0; i < s.m; ++i)
+  {
+    std::vector<float> row(s.n, 0.0f);
+    float *r = row.data();
+    for (uint32_t k = 0; k < s.k; ++k)
+    {
+      const float v = pa[i * s.lda + k];
+      const float *pbk = pb + (size_t) k * s.ldb;
+      for (uint32_t j = 0; j < s.n; ++j)
+        r[j] += v * pbk[j];
+    }
+    float *pci = pc + (size_t) i * s.ldc;
+    for (uint32_t j = 0; j < s.n; ++j)
+      pci[j] = alpha * r[j] + (beta != 0.0f ? beta * pci[j] : 0.0f);
+  }
+}
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC pop_options
+#endif
+
+TEST (Vulkan, Gemm)
+{
+  std::shared_ptr<Vulkan::Device> dev = std::make_shared<Vulkan::Device>(Vulkan::DeviceConfig()
+                                          .SetDeviceType(Vulkan::PhysicalDeviceType::Discrete)
+                                          .SetQueueType(Vulkan::QueueType::ComputeType));
+  Vulkan::GemmShape shape = { 133, 70, 45, 48, 72, 75 };
+  std::vector<float> a(shape.m * shape.lda), b(shape.k * shape.ldb), c(shape.m * shape.ldc);
+  uint32_t seed = 7;
+  auto random = [&seed] () { seed = seed * 1664525u + 1013904223u; return (float) (seed >> 8) / (float) (1 << 24) - 0.5f; };
+  std::generate(a.begin(), a.end(), random);
+  std::generate(b.begin(), b.end(), random);
+  std::generate(c.begin(), c.end(), random);
+
+  Vulkan::StorageArray array(dev);
+  EXPECT_EQ(array.StartConfig(Vulkan::HostVisibleMemory::HostVisible), VK_SUCCESS);
+  EXPECT_EQ(array.AddBuffer(Vulkan::BufferConfig().AddSubBuffer(a).AddSubBuffer(b).AddSubBuffer(c)), VK_SUCCESS);
+  EXPECT_EQ(array.EndConfig(), VK_SUCCESS);
+  EXPECT_EQ(array.SetSubBufferData(0, 0, a), VK_SUCCESS);
+  EXPECT_EQ(array.SetSubBufferData(0, 1, b), VK_SUCCESS);
+
+  Vulkan::Gemm gemm(dev);
+  EXPECT_EQ(gemm.IsValid(), true);
+  Vulkan::CommandPool pool(dev, dev->GetComputeFamilyQueueIndex().value());
+  for (auto kernel : { Vulkan::GemmKernel::Small, Vulkan::GemmKernel::Medium, Vulkan::GemmKernel::Large })
+  {
+    if (!gemm.IsKernelAvailable(kernel))
+      continue;
+
+    EXPECT_EQ(array.SetSubBufferData(0, 2, c), VK_SUCCESS);
+    auto &cmd = pool.GetCommandBuffer(0, VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+    cmd.BeginCommandBuffer();
+    EXPECT_EQ(gemm.Multiply(cmd, array, 0, {0, 1, 2}, shape, 2.0f, 0.5f, kernel), VK_SUCCESS);
+    cmd.EndCommandBuffer();
+
+    if (Vulkan::Fence f(dev); f.IsValid())
+    {
+      EXPECT_EQ(pool.ExecuteBuffer(0, f.GetFence()), VK_SUCCESS);
+      EXPECT_EQ(f.Wait(), VK_SUCCESS);
+    }
+
+    std::vector<float> expected = c, result(c.size());
+    CpuGemm(a, b, expected, shape, 2.0f, 0.5f);
+    EXPECT_EQ(array.GetSubBufferData(0, 2, result), VK_SUCCESS);
+    for (size_t i = 0; i < result.size(); ++i)
+      EXPECT_NEAR(result[i], expected[i], 1e-3f);
+  }
+
+  auto &cmd = pool.GetCommandBuffer(0, VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+  EXPECT_NE(gemm.Multiply(cmd, array, 0, {0, 1, 2}, { shape.m, shape.n, shape.k, shape.k - 1 }), VK_SUCCESS);
+}
+
+TEST (Vulkan, GemmBenchmark)
+{
+  std::shared_ptr<Vulkan::Device> dev = std::make_shared<Vulkan::Device>(Vulkan::DeviceConfig()
+                                          .SetDeviceType(Vulkan::PhysicalDeviceType::Discrete)
+                                          .SetQueueType(Vulkan::QueueType::ComputeType));
+  const uint32_t n = 1024;
+  Vulkan::GemmShape shape = { n, n, n, n, n, n };
+  std::vector<float> a(n * n, 1.0f), b(n * n, 0.5f), c(n * n, 0.0f);
+  const double gflop = 2.0 * n * n * n / 1e9;
+
+  auto start = std::chrono::steady_clock::now();
+  CpuGemm(a, b, c, shape, 1.0f, 0.0f);
+  std::chrono::duration<double> cpu_elapsed = std::chrono::steady_clock::now() - start;
+  std::cout << "CPU (OpenMP): " << gflop / cpu_elapsed.count() << " GFLOP/s" << std::endl;
+
+  Vulkan::StorageArray staging(dev);
+  EXPECT_EQ(staging.StartConfig(Vulkan::HostVisibleMemory::HostVisible), VK_SUCCESS);
+  EXPECT_EQ(staging.AddBuffer(Vulkan::BufferConfig().AddSubBufferRange(3, a)), VK_SUCCESS);
+  EXPECT_EQ(staging.EndConfig(), VK_SUCCESS);
+  EXPECT_EQ(staging.SetSubBufferData(0, 0, a), VK_SUCCESS);
+  EXPECT_EQ(staging.SetSubBufferData(0, 1, b), VK_SUCCESS);
+
+  Vulkan::StorageArray array(dev);
+  EXPECT_EQ(array.StartConfig(Vulkan::HostVisibleMemory::HostInvisible), VK_SUCCESS);
+  EXPECT_EQ(array.AddBuffer(Vulkan::BufferConfig().AddSubBufferRange(3, a)), VK_SUCCESS);
+  EXPECT_EQ(array.EndConfig(), VK_SUCCESS);
+
+  auto copy = [&staging, &array] (const bool upload)
+  {
+    std::vector<VkBufferCopy> regions;
+    for (size_t i = 0; i < 3; ++i)
+    {
+      auto host = Vulkan::BufferRange::FromSubBuffer(staging, 0, i);
+      auto local = Vulkan::BufferRange::FromSubBuffer(array, 0, i);
+      regions.push_back(upload ? VkBufferCopy{ host.offset, local.offset, host.size } : VkBufferCopy{ local.offset, host.offset, host.size });
+    }
+    return regions;
+  };
+
+  auto family = dev->GetComputeFamilyQueueIndex().value();
+  Vulkan::Gemm gemm(dev);
+  Vulkan::CommandPool pool(dev, family);
+  Vulkan::TimestampQueryPool queries(dev, 2, family);
+
+  pool.GetCommandBuffer(0, VK_COMMAND_BUFFER_LEVEL_PRIMARY)
+      .BeginCommandBuffer()
+      .CopyBufferToBuffer(staging.GetInfo(0).buffer, array.GetInfo(0).buffer, copy(true))
+      .EndCommandBuffer();
+  if (Vulkan::Fence f(dev); f.IsValid())
+  {
+    EXPECT_EQ(pool.ExecuteBuffer(0, f.GetFence()), VK_SUCCESS);
+    EXPECT_EQ(f.Wait(), VK_SUCCESS);
+  }
+
+  for (auto kernel : { Vulkan::GemmKernel::Small, Vulkan::GemmKernel::Medium, Vulkan::GemmKernel::Large })
+  {
+    if (!gemm.IsKernelAvailable(kernel))
+      continue;
+
+    double best = 0.0;
+    for (size_t i = 0; i < 4; ++i)
+    {
+      gemm.BeginFrame();
+      auto &cmd = pool.GetCommandBuffer(0, VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+      cmd.BeginCommandBuffer();
+      if (queries.IsValid())
+        cmd.ResetQueryPool(queries.GetQueryPool(), 0, 2).WriteTimestamp(queries.GetQueryPool(), 0, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+      EXPECT_EQ(gemm.Multiply(cmd, array, 0, {0, 1, 2}, shape, 1.0f, 0.0f, kernel), VK_SUCCESS);
+      if (queries.IsValid())
+        cmd.WriteTimestamp(queries.GetQueryPool(), 1, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+      cmd.EndCommandBuffer();
+
+      Vulkan::Fence f(dev);
+      start = std::chrono::steady_clock::now();
+      EXPECT_EQ(pool.ExecuteBuffer(0, f.GetFence()), VK_SUCCESS);
+      EXPECT_EQ(f.Wait(), VK_SUCCESS);
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      double seconds = queries.IsValid() ? queries.GetElapsed(0, 1).value_or(0.0) * 1e-9 : elapsed.count();
+      if (i > 0 && seconds > 0.0)
+        best = std::max(best, gflop / seconds);
+    }
+    std::cout << "GPU kernel " << (int) kernel << ": " << best << " GFLOP/s" << std::endl;
+  }
+
+  pool.GetCommandBuffer(0, VK_COMMAND_BUFFER_LEVEL_PRIMARY)
+      .BeginCommandBuffer()
+      .CopyBufferToBuffer(array.GetInfo(0).buffer, staging.GetInfo(0).buffer, copy(false))
+      .EndCommandBuffer();
+  if (Vulkan::Fence f(dev); f.IsValid())
+  {
+    EXPECT_EQ(pool.ExecuteBuffer(0, f.GetFence()), VK_SUCCESS);
+    EXPECT_EQ(f.Wait(), VK_SUCCESS);
+  }
+
+  std::vector<float> result(n * n);
+  EXPECT_EQ(staging.GetSubBufferData(0, 2, result), VK_SUCCESS);
+  EXPECT_NEAR(result[0], c[0], 1e-2f);
+  EXPECT_NEAR(result.back(), c.back(), 1e-2f);
+}
+
 TEST (Vulkan, RenderPass)
 {
   std::shared_ptr<Vulkan::Surface> surf = std::make_shared<Vulkan::Surface>(Vulkan::SurfaceConfig()